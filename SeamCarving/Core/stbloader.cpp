@@ -15,13 +15,14 @@ Texture LoadTexture(std::string const& file)
         return texture;
     }
 
-    texture.pixels.resize(texture.width * texture.height);
+    texture.Allocate(texture.width, texture.height);
     for (int i = 0; i < texture.width * texture.height; ++i)
     {
         std::memcpy(texture.pixels[i].data, data + 4 * i, 4);
     }
 
     stbi_image_free(data);
+    texture.BuildLuminance();
 
     glGenTextures(1, &texture.id);
     glBindTexture(GL_TEXTURE_2D, texture.id);
@@ -37,8 +38,11 @@ Texture LoadTexture(std::string const& file)
 
 void UpdateTexture(Texture const& texture)
 {
+    // rows are stride pixels apart once seams have been removed in place
     glBindTexture(GL_TEXTURE_2D, texture.id);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, texture.stride);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.width, texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.pixels.data());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     std::cout << "Imaged updated." << std::endl;
 }
 
@@ -52,7 +56,7 @@ bool SaveTextureAsPNG(Texture const& texture, std::string const& filename)
         texture.height,
         4,                      // 4 channels: RGBA
         data,
-        texture.width * 4       // stride in bytes
+        texture.stride * 4      // stride in bytes
     );
 
     if (result != 0)  std::cout << "Image exported. " << filename << std::endl;
@@ -2,6 +2,8 @@
 #include "../SeamCarving/analysis.hpp"
 #include "../SeamCarving/seamcarvingdp.hpp"
 #include "../SeamCarving/seamcarvinggreedy.hpp"
+#include "../SeamCarving/energy.hpp"
+#include "../SeamCarving/parallel.hpp"
 
 namespace Analysis
 {
@@ -19,8 +21,8 @@ namespace Analysis
         metrics.computationTimeMs = elapsed.count();
         metrics.seamEnergy = DP::CalculateVerticalSeamEnergy(energy, outSeam);
 
-        // Memory estimation: cumulative grid (width * height * sizeof(float))
-        metrics.memoryUsed = energy.width * energy.height * sizeof(float);
+        // Memory estimation: int8 step table plus two rolling cumulative rows
+        metrics.memoryUsed = energy.width * energy.height * sizeof(signed char) + 2 * energy.width * sizeof(float);
 
         return metrics;
     }
@@ -59,8 +61,133 @@ namespace Analysis
         metrics.computationTimeMs = elapsed.count();
         metrics.seamEnergy = DP::CalculateHorizontalSeamEnergy(energy, outSeam);
 
-        // Memory estimation: cumulative grid
-        metrics.memoryUsed = energy.width * energy.height * sizeof(float);
+        // Memory estimation: transposed energy, int8 step table and two rolling cumulative columns
+        metrics.memoryUsed = energy.width * energy.height * (sizeof(float) + sizeof(signed char)) + 2 * energy.height * sizeof(float);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPForwardVerticalSeam(Texture const& texture, Grid<float> const& energy, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindVerticalSeamForward(texture);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateVerticalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: cumulative grid plus three cost rows, no energy grid
+        metrics.memoryUsed = (texture.width * texture.height + 3 * texture.width) * sizeof(float);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPStreamingVerticalSeam(Texture const& texture, Grid<float> const& energy, Energy::Operator op, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindVerticalSeamStreaming(texture, op);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateVerticalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: int8 step table plus one energy and two cumulative rows, no energy grid
+        metrics.memoryUsed = texture.width * texture.height * sizeof(signed char) + 3 * texture.width * sizeof(float);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPLowMemoryVerticalSeam(Grid<float> const& energy, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindVerticalSeamLowMemory(energy);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateVerticalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: 2-bit codes (four per byte), two rolling float rows and one int8 step row
+        metrics.memoryUsed = (energy.width + 3) / 4 * energy.height + 2 * energy.width * sizeof(float) + energy.width * sizeof(signed char);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPLowMemoryHorizontalSeam(Grid<float> const& energy, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindHorizontalSeamLowMemory(energy);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateHorizontalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: 2-bit codes, two rolling float columns, the gathered energy column and one int8 step column
+        metrics.memoryUsed = (energy.height + 3) / 4 * energy.width + 3 * energy.height * sizeof(float) + energy.height * sizeof(signed char);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPCheckpointedVerticalSeam(Grid<float> const& energy, std::size_t memoryBudget, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindVerticalSeamCheckpointed(energy, memoryBudget);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateVerticalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: the plain int8 step table within budget, otherwise the checkpoint rows,
+        // one segment of int8 steps and the rolling rows
+        std::size_t table = std::size_t(energy.width) * energy.height * sizeof(signed char);
+        int interval = DP::CheckpointInterval(energy.height);
+        int count = (energy.height + interval - 1) / interval;
+        metrics.memoryUsed = table <= memoryBudget ? table + 2 * energy.width * sizeof(float)
+            : (count + 2) * energy.width * sizeof(float) + (interval + 1) * energy.width * sizeof(signed char);
+
+        return metrics;
+    }
+
+    PerformanceMetrics MeasureDPForwardHorizontalSeam(Texture const& texture, Grid<float> const& energy, std::vector<int>& outSeam)
+    {
+        PerformanceMetrics metrics;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        outSeam = DP::FindHorizontalSeamForward(texture);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> elapsed = end - start;
+
+        metrics.computationTimeMs = elapsed.count();
+        metrics.seamEnergy = DP::CalculateHorizontalSeamEnergy(energy, outSeam);
+
+        // Memory estimation: cumulative grid plus three cost columns
+        metrics.memoryUsed = (texture.width * texture.height + 3 * texture.height) * sizeof(float);
 
         return metrics;
     }
@@ -85,6 +212,245 @@ namespace Analysis
         return metrics;
     }
 
+    void CompareEnergyKernels(Texture const& texture, int iterations)
+    {
+        iterations = std::max(iterations, 1);
+
+        // Average time per run of one energy kernel, keeping the last result
+        auto timeKernel = [&](Grid<float>(*kernel)(Texture const&), Grid<float>& result)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; ++i) result = kernel(texture);
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+        };
+
+        Grid<float> scalar(0, 0), split(0, 0), simd(0, 0), parallel(0, 0);
+        double scalarMs = timeKernel(Energy::ComputeScalar, scalar);
+        double splitMs = timeKernel(Energy::ComputeSplit, split);
+        double simdMs = timeKernel([](Texture const& t) { return Energy::ComputeSIMD(t); }, simd);
+        double parallelMs = timeKernel([](Texture const& t) { return Energy::ComputeParallel(t); }, parallel);
+
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < scalar.data.size(); ++i)
+        {
+            maxDiff = std::max(maxDiff, std::abs(scalar.data[i] - split.data[i]));
+            maxDiff = std::max(maxDiff, std::abs(scalar.data[i] - simd.data[i]));
+            maxDiff = std::max(maxDiff, std::abs(scalar.data[i] - parallel.data[i]));
+        }
+
+        std::cout << "\n=== Energy Kernels: " << texture.width << "x" << texture.height
+            << " (" << iterations << " runs) ===" << std::endl;
+        std::cout << std::fixed << std::setprecision(4);
+        std::cout << "Scalar (clamped): " << scalarMs << " ms" << std::endl;
+        std::cout << "Scalar (split): " << splitMs << " ms (" << scalarMs / splitMs << "x)" << std::endl;
+        std::cout << Energy::SIMDLevel() << ": " << simdMs << " ms (" << scalarMs / simdMs << "x)" << std::endl;
+        std::cout << Energy::SIMDLevel() << " x " << Parallel::HardwareWorkers() << " threads"
+            << (texture.width * texture.height < Energy::kParallelThreshold ? " (serial, below threshold)" : "")
+            << ": " << parallelMs << " ms (" << scalarMs / parallelMs << "x)" << std::endl;
+        std::cout << "Max abs difference: " << maxDiff << (maxDiff == 0.0f ? " (exact)" : "") << std::endl;
+    }
+
+    void CompareEnergyOperators(Texture const& texture, int iterations)
+    {
+        iterations = std::max(iterations, 1);
+
+        Grid<float> reference = Energy::ComputeSIMD(texture, Energy::Operator::L2);
+        std::vector<int> referenceSeam = DP::FindVerticalSeam(reference);
+
+        std::cout << "\n=== Energy Operators: " << texture.width << "x" << texture.height
+            << " (" << iterations << " runs) ===" << std::endl;
+        std::cout << std::fixed << std::setprecision(4);
+
+        for (int i = 0; i < static_cast<int>(Energy::Operator::Count); ++i)
+        {
+            Energy::Operator op = static_cast<Energy::Operator>(i);
+            Grid<float> energy = reference;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int run = 0; run < iterations; ++run) energy = Energy::ComputeSIMD(texture, op);
+            auto end = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+
+            // seam quality is judged on the reference L2 energy so operators are comparable
+            std::vector<int> seam = DP::FindVerticalSeam(energy);
+            int differences = 0;
+            for (size_t y = 0; y < seam.size(); ++y)
+            {
+                if (seam[y] != referenceSeam[y]) ++differences;
+            }
+
+            std::cout << std::setw(12) << Energy::OperatorName(op) << ": " << ms << " ms"
+                << ", vertical seam L2 energy " << DP::CalculateVerticalSeamEnergy(reference, seam)
+                << ", " << differences << " rows differ from L2" << std::endl;
+        }
+    }
+
+    void CompareFixedPointSeams(Texture const& texture, Energy::Operator op)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        Grid<float> energy = DP::ComputeEnergy(texture, op);
+        auto end = std::chrono::high_resolution_clock::now();
+        double floatEnergyMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        float scale = 1.0f;
+        Grid<uint16_t> quantized = Energy::ComputeQuantized(texture, op, &scale);
+        end = std::chrono::high_resolution_clock::now();
+        double fixedEnergyMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "\n=== Fixed-Point DP: " << energy.width << "x" << energy.height
+            << " (scale " << scale << ") ===" << std::endl;
+        std::cout << "Energy: float " << floatEnergyMs << " ms, fixed " << fixedEnergyMs << " ms" << std::endl;
+        std::cout << "Memory (energy + cumulative): float " << energy.width * energy.height * (sizeof(float) + sizeof(float))
+            << " bytes, fixed " << energy.width * energy.height * (sizeof(uint16_t) + sizeof(uint32_t)) << " bytes" << std::endl;
+
+        for (int vertical = 1; vertical >= 0; --vertical)
+        {
+            start = std::chrono::high_resolution_clock::now();
+            std::vector<int> floatSeam = vertical ? DP::FindVerticalSeam(energy) : DP::FindHorizontalSeam(energy);
+            end = std::chrono::high_resolution_clock::now();
+            double floatMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+            start = std::chrono::high_resolution_clock::now();
+            std::vector<int> fixedSeam = vertical ? DP::FindVerticalSeamFixed(quantized) : DP::FindHorizontalSeamFixed(quantized);
+            end = std::chrono::high_resolution_clock::now();
+            double fixedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+            float floatEnergy = vertical ? DP::CalculateVerticalSeamEnergy(energy, floatSeam) : DP::CalculateHorizontalSeamEnergy(energy, floatSeam);
+            float fixedEnergy = vertical ? DP::CalculateVerticalSeamEnergy(energy, fixedSeam) : DP::CalculateHorizontalSeamEnergy(energy, fixedSeam);
+
+            int differences = 0;
+            for (size_t i = 0; i < floatSeam.size(); ++i)
+            {
+                if (floatSeam[i] != fixedSeam[i]) ++differences;
+            }
+
+            std::cout << (vertical ? "Vertical" : "Horizontal") << ": float " << floatMs << " ms, fixed " << fixedMs
+                << " ms, " << differences << " positions differ";
+
+            if (differences == 0)
+            {
+                std::cout << " (identical)" << std::endl;
+            }
+            else if (std::abs(fixedEnergy - floatEnergy) <= 1e-5f * std::max(floatEnergy, 1.0f))
+            {
+                std::cout << " (energy tie: " << floatEnergy << ")" << std::endl;
+            }
+            else
+            {
+                std::cout << " (quantisation: float " << floatEnergy << " vs fixed " << fixedEnergy << ")" << std::endl;
+            }
+        }
+    }
+
+    void ComparePyramidEnergy(Texture const& texture, Energy::Operator op)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        Grid<float> full = Energy::ComputeParallel(texture, op);
+        auto end = std::chrono::high_resolution_clock::now();
+        double fullMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::vector<int> fullVertical = DP::FindVerticalSeam(full);
+        std::vector<int> fullHorizontal = DP::FindHorizontalSeam(full);
+        float fullVerticalEnergy = DP::CalculateVerticalSeamEnergy(full, fullVertical);
+        float fullHorizontalEnergy = DP::CalculateHorizontalSeamEnergy(full, fullHorizontal);
+
+        std::cout << "\n=== Pyramid Energy (" << Energy::OperatorName(op) << ", " << texture.width << "x" << texture.height << ") ===" << std::endl;
+        std::cout << "Full resolution: " << fullMs << " ms, vertical seam " << fullVerticalEnergy
+            << ", horizontal seam " << fullHorizontalEnergy << std::endl;
+
+        for (int factor = 2; factor <= 4; factor *= 2)
+        {
+            start = std::chrono::high_resolution_clock::now();
+            Grid<float> pyramid = Energy::ComputePyramid(texture, factor, op);
+            end = std::chrono::high_resolution_clock::now();
+            double pyramidMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+            std::cout << "1/" << factor << ": " << pyramidMs << " ms (" << fullMs / pyramidMs << "x)" << std::endl;
+
+            for (int vertical = 1; vertical >= 0; --vertical)
+            {
+                std::vector<int> seam = vertical ? DP::FindVerticalSeam(pyramid) : DP::FindHorizontalSeam(pyramid);
+                std::vector<int> const& reference = vertical ? fullVertical : fullHorizontal;
+
+                // both seams are scored on the full-resolution energy
+                float energy = vertical ? DP::CalculateVerticalSeamEnergy(full, seam) : DP::CalculateHorizontalSeamEnergy(full, seam);
+                float referenceEnergy = vertical ? fullVerticalEnergy : fullHorizontalEnergy;
+
+                int differences = 0;
+                int maxDiff = 0;
+                for (size_t i = 0; i < seam.size(); ++i)
+                {
+                    int diff = std::abs(seam[i] - reference[i]);
+                    if (diff > 0) ++differences;
+                    maxDiff = std::max(maxDiff, diff);
+                }
+
+                std::cout << "  " << (vertical ? "Vertical" : "Horizontal") << ": seam energy " << energy;
+                if (referenceEnergy > 0.0f) std::cout << " (+" << (energy / referenceEnergy - 1.0f) * 100.0f << "%)";
+                std::cout << ", " << differences << " positions differ, max offset " << maxDiff << std::endl;
+            }
+        }
+    }
+
+    void CompareMultiresolutionSeams(Texture const& texture, Energy::Operator op, int levels, int bandRadius, int seams)
+    {
+        Texture work = texture;
+        int differing = 0;
+        int maxDiff = 0;
+        double fullMs = 0.0;
+        double excess = 0.0;
+        seams = std::min(seams, texture.width - 1);
+
+        // the pyramid is built once and carved along with the image, its cost counts for the banded search
+        auto start = std::chrono::high_resolution_clock::now();
+        DP::SeamPyramid pyramid;
+        pyramid.Build(work, levels, bandRadius);
+        auto end = std::chrono::high_resolution_clock::now();
+        double bandedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        for (int i = 0; i < seams; ++i)
+        {
+            // the full search is timed with its energy pass, the banded search computes its own energy
+            start = std::chrono::high_resolution_clock::now();
+            Grid<float> energy = DP::ComputeEnergy(work, op);
+            std::vector<int> full = DP::FindVerticalSeam(energy);
+            end = std::chrono::high_resolution_clock::now();
+            fullMs += std::chrono::duration<double, std::milli>(end - start).count();
+
+            start = std::chrono::high_resolution_clock::now();
+            std::vector<int> banded = DP::FindVerticalSeamMultiresolution(work, pyramid, bandRadius, op);
+            end = std::chrono::high_resolution_clock::now();
+            bandedMs += std::chrono::duration<double, std::milli>(end - start).count();
+
+            if (banded != full) ++differing;
+            for (size_t y = 0; y < full.size(); ++y)
+            {
+                maxDiff = std::max(maxDiff, std::abs(banded[y] - full[y]));
+            }
+
+            float fullEnergy = DP::CalculateVerticalSeamEnergy(energy, full);
+            if (fullEnergy > 0.0f) excess += DP::CalculateVerticalSeamEnergy(energy, banded) / fullEnergy - 1.0;
+
+            DP::CompactVerticalSeam(work, full);
+
+            start = std::chrono::high_resolution_clock::now();
+            pyramid.RemoveVerticalSeam(work, full);
+            end = std::chrono::high_resolution_clock::now();
+            bandedMs += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        if (seams <= 0) return;
+
+        std::cout << "\n=== Multiresolution Seams (" << Energy::OperatorName(op) << ", " << levels << " levels, band +-"
+            << bandRadius << ", " << texture.width << "x" << texture.height << ") ===" << std::endl;
+        std::cout << "Full DP: " << fullMs / seams << " ms per seam, banded: " << bandedMs / seams << " ms per seam ("
+            << fullMs / bandedMs << "x)" << std::endl;
+        std::cout << differing << " of " << seams << " seams differ from the full optimum, mean extra energy "
+            << excess / seams * 100.0 << "%, max offset " << maxDiff << std::endl;
+    }
+
     void CompareSeams(std::vector<int> const& seam1, std::vector<int> const& seam2,
         std::string const& name1, std::string const& name2)
     {
@@ -1,5 +1,6 @@
 
 #pragma once
+#include "energy.hpp"
 #include <chrono>
 
 namespace Analysis
@@ -21,9 +22,43 @@ namespace Analysis
     // Measure the time and memory for DP horizontal seam
     PerformanceMetrics MeasureDPHorizontalSeam(Grid<float> const& energy, std::vector<int>& outSeam);
 
+    // Measure the time and memory for forward-energy DP seams, seam energy is taken from the backward energy
+    PerformanceMetrics MeasureDPForwardVerticalSeam(Texture const& texture, Grid<float> const& energy, std::vector<int>& outSeam);
+    PerformanceMetrics MeasureDPForwardHorizontalSeam(Texture const& texture, Grid<float> const& energy, std::vector<int>& outSeam);
+
+    // Measure the fused streaming DP; its time includes the energy pass, which it computes row by row
+    PerformanceMetrics MeasureDPStreamingVerticalSeam(Texture const& texture, Grid<float> const& energy, Energy::Operator op, std::vector<int>& outSeam);
+
+    // Measure the low-memory DP (rolling lines, 2-bit packed steps); memory counts every buffer it allocates
+    PerformanceMetrics MeasureDPLowMemoryVerticalSeam(Grid<float> const& energy, std::vector<int>& outSeam);
+    PerformanceMetrics MeasureDPLowMemoryHorizontalSeam(Grid<float> const& energy, std::vector<int>& outSeam);
+
+    // Measure the checkpointed DP with the given budget (0 always checkpoints)
+    PerformanceMetrics MeasureDPCheckpointedVerticalSeam(Grid<float> const& energy, std::size_t memoryBudget, std::vector<int>& outSeam);
+
     // Measure the time and memory for Greedy horizontal seam
     PerformanceMetrics MeasureGreedyHorizontalSeam(Grid<float> const& energy, std::vector<int>& outSeam);
 
+    // Time the clamped reference energy against the split and vectorised kernels and check they agree
+    void CompareEnergyKernels(Texture const& texture, int iterations);
+
+    // Time every energy operator and compare its DP vertical seam against the L2 seam
+    void CompareEnergyOperators(Texture const& texture, int iterations);
+
+    // Run the float DP and the fixed-point DP (energy from Energy::ComputeQuantized) at full resolution,
+    // report timings, memory and whether any difference in the chosen seams is an energy tie or a
+    // quantisation effect
+    void CompareFixedPointSeams(Texture const& texture, Energy::Operator op = Energy::Operator::L2);
+
+    // Time pyramid energy at 1/2 and 1/4 resolution against full resolution and report how much
+    // full-resolution energy the seams found on the upsampled maps cost, and where they move
+    void ComparePyramidEnergy(Texture const& texture, Energy::Operator op);
+
+    // Carve `seams` vertical seams with the full DP and, before each, run the coarse-to-fine banded search
+    // on the same image with a pyramid carved along; report how often it differs from the full optimum,
+    // its extra seam energy and timings
+    void CompareMultiresolutionSeams(Texture const& texture, Energy::Operator op, int levels, int bandRadius, int seams);
+
     // Compare two seams visually by highlighting differences
     void CompareSeams(std::vector<int> const& seam1, std::vector<int> const& seam2,
         std::string const& name1, std::string const& name2);
@@ -0,0 +1,63 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    int CheckpointInterval(int height)
+    {
+        return std::max(1, static_cast<int>(std::ceil(std::sqrt(double(height)))));
+    }
+
+    std::vector<int> FindVerticalSeamCheckpointed(Grid<float> const& energy, std::size_t memoryBudget)
+    {
+        int width = energy.width;
+        int height = energy.height;
+
+        // the wavefront search keeps a full int8 step table, use it while that fits
+        if (std::size_t(width) * height * sizeof(signed char) <= memoryBudget) return FindVerticalSeamParallel(energy);
+
+        int interval = CheckpointInterval(height);
+        int count = (height + interval - 1) / interval;
+
+        // forward pass: rolling rows, every interval-th cumulative row is kept, steps are discarded
+        Grid<float> checkpoints(width, count);
+        std::vector<float> previous(energy.Row(0), energy.Row(0) + width);
+        std::vector<float> current(width);
+        std::vector<signed char> scratch(width);
+        std::copy(previous.begin(), previous.end(), checkpoints.Row(0));
+
+        for (int y = 1; y < height; ++y)
+        {
+            RelaxRow(previous.data(), energy.Row(y), current.data(), scratch.data(), width);
+            std::swap(previous, current);
+            if (y % interval == 0) std::copy(previous.begin(), previous.end(), checkpoints.Row(y / interval));
+        }
+
+        std::vector<int> seam(height);
+        seam[height - 1] = static_cast<int>(std::min_element(previous.begin(), previous.end()) - previous.begin());
+
+        // backward pass: segments bottom-up, each replayed from its checkpoint down to the next one,
+        // whose seam column is already known, then backtracked through its own steps
+        Grid<signed char> steps(width, interval);
+
+        for (int k = count - 1; k >= 0; --k)
+        {
+            int begin = k * interval;
+            int end = std::min(begin + interval, height - 1);
+
+            std::copy(checkpoints.Row(k), checkpoints.Row(k) + width, previous.begin());
+            for (int y = begin + 1; y <= end; ++y)
+            {
+                RelaxRow(previous.data(), energy.Row(y), current.data(), steps.Row(y - begin - 1), width);
+                std::swap(previous, current);
+            }
+
+            for (int y = end; y > begin; --y)
+            {
+                seam[y - 1] = seam[y] + steps.Row(y - begin - 1)[seam[y]];
+            }
+        }
+
+        return seam;
+    }
+}
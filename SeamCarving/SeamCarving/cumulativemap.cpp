@@ -0,0 +1,139 @@
+#include "../pch.h"
+#include "cumulativemap.hpp"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    void CumulativeMap::Build(Grid<float> const& energy)
+    {
+        cumulative = Grid<float>(energy.width, energy.height);
+        BuildFrom(energy, 0);
+    }
+
+    void CumulativeMap::BuildFrom(Grid<float> const& energy, int firstRow)
+    {
+        int width = energy.width;
+        int height = energy.height;
+        lastUpdated = width * (height - firstRow);
+
+        if (firstRow == 0)
+        {
+            std::copy(energy.Row(0), energy.Row(0) + width, cumulative.Row(0));
+            firstRow = 1;
+        }
+
+        // the steps are not needed, backtracking re-reads the persistent sums
+        std::vector<signed char> steps(width);
+        for (int y = firstRow; y < height; ++y)
+        {
+            RelaxRow(cumulative.Row(y - 1), energy.Row(y), cumulative.Row(y), steps.data(), width);
+        }
+    }
+
+    std::vector<int> CumulativeMap::FindVerticalSeam() const
+    {
+        int width = cumulative.width;
+        int height = cumulative.height;
+        std::vector<int> seam(height);
+
+        float const* bottom = cumulative.Row(height - 1);
+        seam[height - 1] = static_cast<int>(std::min_element(bottom, bottom + width) - bottom);
+
+        // same tie-breaking as RelaxRow: straight up, then left, then right
+        for (int y = height - 2; y >= 0; --y)
+        {
+            float const* row = cumulative.Row(y);
+            int prevX = seam[y + 1];
+            int bestX = prevX;
+
+            if (prevX > 0 && row[prevX - 1] < row[bestX]) bestX = prevX - 1;
+            if (prevX < width - 1 && row[prevX + 1] < row[bestX]) bestX = prevX + 1;
+
+            seam[y] = bestX;
+        }
+
+        return seam;
+    }
+
+    void CumulativeMap::RemoveVerticalSeam(Grid<float> const& energy, std::vector<int> const& seam)
+    {
+        int oldWidth = cumulative.width;
+        int width = oldWidth - 1;
+        int height = cumulative.height;
+        float* data = cumulative.data.data();
+
+        // columns of the previous row whose new sum differs from its shifted old sum
+        int changedBegin = 0;
+        int changedEnd = 0;
+        lastUpdated = 0;
+
+        for (int y = 0; y < height; ++y)
+        {
+            // drop the seam column; rows only move towards the front, so compacting in order is safe
+            int s = seam[y];
+            float* row = data + y * width;
+            float const* old = data + y * oldWidth;
+            std::memmove(row, old, s * sizeof(float));
+            std::memmove(row + s, old + s + 1, (oldWidth - s - 1) * sizeof(float));
+
+            // where the seam steps between rows the parents of a column are no longer its old parents,
+            // and CarveVerticalEnergy changed energy up to one column either side of seam[y - 1 .. y + 1]
+            int above = seam[std::max(y - 1, 0)];
+            int below = seam[std::min(y + 1, height - 1)];
+            int begin = std::min({ above, s, below }) - 1;
+            int end = std::max({ above, s, below }) + 1;
+
+            // sums of the previous row that changed reach one column further either way
+            if (changedBegin < changedEnd)
+            {
+                begin = std::min(begin, changedBegin - 1);
+                end = std::max(end, changedEnd + 1);
+            }
+
+            begin = std::max(begin, 0);
+            end = std::min(end, width);
+
+            float const* energyRow = energy.Row(y);
+            float const* prev = y > 0 ? data + (y - 1) * width : nullptr;
+
+            changedBegin = end;
+            changedEnd = begin;
+
+            for (int x = begin; x < end; ++x)
+            {
+                float value = energyRow[x];
+                if (prev)
+                {
+                    float best = prev[x];
+                    if (x > 0) best = std::min(best, prev[x - 1]);
+                    if (x < width - 1) best = std::min(best, prev[x + 1]);
+                    value += best;
+                }
+
+                // early stop: only columns whose sum really moved widen the cone for the next row
+                if (value != row[x])
+                {
+                    row[x] = value;
+                    changedBegin = std::min(changedBegin, x);
+                    changedEnd = x + 1;
+                }
+            }
+
+            lastUpdated += std::max(end - begin, 0);
+        }
+
+        cumulative.width = width;
+        cumulative.data.resize(width * height);
+    }
+
+    void CumulativeMap::RemoveHorizontalSeam(Grid<float> const& energy, std::vector<int> const& seam)
+    {
+        // CarveHorizontalEnergy leaves energy rows above min(seam) - 1 untouched, and a sum depends
+        // only on the rows above it
+        int firstRow = std::max(*std::min_element(seam.begin(), seam.end()) - 1, 0);
+
+        cumulative.height = energy.height;
+        cumulative.data.resize(cumulative.width * cumulative.height);
+        BuildFrom(energy, firstRow);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace DP
+{
+	// Vertical cumulative energy kept alive across a resize and patched after every removed seam.
+	// A vertical seam only changes the sums inside the cone spreading down from it, so each row is
+	// recomputed over that cone alone and the cone narrows again wherever the new sums match the old.
+	// The map is a full W x H float grid, four times the step table FindVerticalSeamCheckpointed keeps
+	// within its budget, so resizes built on it stay out of reach for gigapixel inputs.
+	struct CumulativeMap
+	{
+		Grid<float> cumulative{ 0, 0 };
+		int lastUpdated = 0; // sums recomputed by the last Build / Remove call
+
+		void Build(Grid<float> const& energy);
+
+		// Same seam as DP::FindVerticalSeam on the energy the map was built from
+		std::vector<int> FindVerticalSeam() const;
+
+		// Call after the seam was removed from the texture and carved out of the energy with
+		// CarveVerticalEnergy (full resolution), which changes energy only next to the seam
+		void RemoveVerticalSeam(Grid<float> const& energy, std::vector<int> const& seam);
+
+		// Rows above a horizontal seam keep their sums, the rows from its highest point down are rebuilt
+		void RemoveHorizontalSeam(Grid<float> const& energy, std::vector<int> const& seam);
+
+	private:
+		void BuildFrom(Grid<float> const& energy, int firstRow);
+	};
+}
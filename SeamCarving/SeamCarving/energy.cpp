@@ -0,0 +1,711 @@
+#include "../pch.h"
+#include "energy.hpp"
+#include "simd.hpp"
+#include "parallel.hpp"
+
+namespace Energy
+{
+    namespace
+    {
+        // Per-channel RGB gradients of one pixel, alpha is ignored
+        struct Gradient
+        {
+            int dx[3];
+            int dy[3];
+        };
+
+#if defined(SEAMCARVING_AVX2)
+        using VecI = __m256i;
+        constexpr int kLanes = 8;
+
+        inline VecI Load(Pixel const* p) { return _mm256_and_si256(_mm256_loadu_si256((VecI const*)p), _mm256_set1_epi32(0x00FFFFFF)); }
+        // widen bytes to int16, per 128-bit lane: half 0 = pixels {0,1 | 4,5}, half 1 = pixels {2,3 | 6,7}
+        inline VecI Widen(VecI v, int half) { return half == 0 ? _mm256_unpacklo_epi8(v, _mm256_setzero_si256()) : _mm256_unpackhi_epi8(v, _mm256_setzero_si256()); }
+        inline VecI Add16(VecI a, VecI b) { return _mm256_add_epi16(a, b); }
+        inline VecI Sub16(VecI a, VecI b) { return _mm256_sub_epi16(a, b); }
+        inline VecI Mul16(VecI a, int k) { return _mm256_mullo_epi16(a, _mm256_set1_epi16(short(k))); }
+        inline VecI Abs16(VecI a) { return _mm256_abs_epi16(a); }
+        inline VecI Madd16(VecI a, VecI b) { return _mm256_madd_epi16(a, b); }
+        inline VecI Ones16() { return _mm256_set1_epi16(1); }
+        inline VecI Add32(VecI a, VecI b) { return _mm256_add_epi32(a, b); }
+
+        // madd leaves (r + g, b + 0) partials per pixel, fold them into one int32 per pixel in order
+        inline VecI PixelSums(VecI half0, VecI half1)
+        {
+            __m256 a = _mm256_castsi256_ps(half0);
+            __m256 b = _mm256_castsi256_ps(half1);
+            VecI even = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            VecI odd = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            return _mm256_add_epi32(even, odd);
+        }
+
+        inline void Store(float* out, VecI sums) { _mm256_storeu_ps(out, _mm256_cvtepi32_ps(sums)); }
+        inline void StoreSqrt(float* out, VecI sums) { _mm256_storeu_ps(out, _mm256_sqrt_ps(_mm256_cvtepi32_ps(sums))); }
+#elif defined(SEAMCARVING_SSE2)
+        using VecI = __m128i;
+        constexpr int kLanes = 4;
+
+        inline VecI Load(Pixel const* p) { return _mm_and_si128(_mm_loadu_si128((VecI const*)p), _mm_set1_epi32(0x00FFFFFF)); }
+        // widen bytes to int16: half 0 = pixels 0,1 and half 1 = pixels 2,3
+        inline VecI Widen(VecI v, int half) { return half == 0 ? _mm_unpacklo_epi8(v, _mm_setzero_si128()) : _mm_unpackhi_epi8(v, _mm_setzero_si128()); }
+        inline VecI Add16(VecI a, VecI b) { return _mm_add_epi16(a, b); }
+        inline VecI Sub16(VecI a, VecI b) { return _mm_sub_epi16(a, b); }
+        inline VecI Mul16(VecI a, int k) { return _mm_mullo_epi16(a, _mm_set1_epi16(short(k))); }
+        inline VecI Abs16(VecI a) { return _mm_max_epi16(a, _mm_sub_epi16(_mm_setzero_si128(), a)); }
+        inline VecI Madd16(VecI a, VecI b) { return _mm_madd_epi16(a, b); }
+        inline VecI Ones16() { return _mm_set1_epi16(1); }
+        inline VecI Add32(VecI a, VecI b) { return _mm_add_epi32(a, b); }
+
+        inline VecI PixelSums(VecI half0, VecI half1)
+        {
+            __m128 a = _mm_castsi128_ps(half0);
+            __m128 b = _mm_castsi128_ps(half1);
+            VecI even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            VecI odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            return _mm_add_epi32(even, odd);
+        }
+
+        inline void Store(float* out, VecI sums) { _mm_storeu_ps(out, _mm_cvtepi32_ps(sums)); }
+        inline void StoreSqrt(float* out, VecI sums) { _mm_storeu_ps(out, _mm_sqrt_ps(_mm_cvtepi32_ps(sums))); }
+#endif
+
+#if defined(SEAMCARVING_SSE2)
+        // Widened gradients of kLanes pixels, split into the two halves produced by Widen
+        struct VecGradient
+        {
+            VecI dx[2];
+            VecI dy[2];
+        };
+#endif
+
+        // Central difference of the left/right and up/down neighbours
+        struct Central
+        {
+            static Gradient Scalar(Pixel const* up, Pixel const* row, Pixel const* down, int left, int x, int right)
+            {
+                Pixel l = row[left], r = row[right], u = up[x], d = down[x];
+                return Gradient{
+                    { int(r.r) - int(l.r), int(r.g) - int(l.g), int(r.b) - int(l.b) },
+                    { int(d.r) - int(u.r), int(d.g) - int(u.g), int(d.b) - int(u.b) } };
+            }
+
+#if defined(SEAMCARVING_SSE2)
+            static VecGradient Vector(Pixel const* up, Pixel const* row, Pixel const* down, int x)
+            {
+                VecI l = Load(row + x - 1);
+                VecI r = Load(row + x + 1);
+                VecI u = Load(up + x);
+                VecI d = Load(down + x);
+
+                VecGradient g;
+                for (int h = 0; h < 2; ++h)
+                {
+                    g.dx[h] = Sub16(Widen(r, h), Widen(l, h));
+                    g.dy[h] = Sub16(Widen(d, h), Widen(u, h));
+                }
+                return g;
+            }
+#endif
+        };
+
+        // 3x3 derivative with weights (Corner, Centre, Corner) across the derivative direction
+        template <int Corner, int Centre>
+        struct Kernel3x3
+        {
+            static Gradient Scalar(Pixel const* up, Pixel const* row, Pixel const* down, int left, int x, int right)
+            {
+                Gradient g;
+                for (int c = 0; c < 3; ++c)
+                {
+                    int ul = up[left].data[c], uc = up[x].data[c], ur = up[right].data[c];
+                    int ml = row[left].data[c], mr = row[right].data[c];
+                    int dl = down[left].data[c], dc = down[x].data[c], dr = down[right].data[c];
+
+                    g.dx[c] = Corner * ((ur - ul) + (dr - dl)) + Centre * (mr - ml);
+                    g.dy[c] = Corner * ((dl - ul) + (dr - ur)) + Centre * (dc - uc);
+                }
+                return g;
+            }
+
+#if defined(SEAMCARVING_SSE2)
+            static VecI Weight(VecI v, int k)
+            {
+                return k == 1 ? v : Mul16(v, k);
+            }
+
+            static VecGradient Vector(Pixel const* up, Pixel const* row, Pixel const* down, int x)
+            {
+                VecI ul = Load(up + x - 1), uc = Load(up + x), ur = Load(up + x + 1);
+                VecI ml = Load(row + x - 1), mr = Load(row + x + 1);
+                VecI dl = Load(down + x - 1), dc = Load(down + x), dr = Load(down + x + 1);
+
+                VecGradient g;
+                for (int h = 0; h < 2; ++h)
+                {
+                    VecI wul = Widen(ul, h), wur = Widen(ur, h);
+                    VecI wdl = Widen(dl, h), wdr = Widen(dr, h);
+
+                    g.dx[h] = Add16(Weight(Add16(Sub16(wur, wul), Sub16(wdr, wdl)), Corner), Weight(Sub16(Widen(mr, h), Widen(ml, h)), Centre));
+                    g.dy[h] = Add16(Weight(Add16(Sub16(wdl, wul), Sub16(wdr, wur)), Corner), Weight(Sub16(Widen(dc, h), Widen(uc, h)), Centre));
+                }
+                return g;
+            }
+#endif
+        };
+
+        using Sobel = Kernel3x3<1, 2>;
+        using Scharr = Kernel3x3<3, 10>;
+
+        // sqrt of the summed squared gradients
+        struct L2Norm
+        {
+            static float Scalar(Gradient const& g)
+            {
+                int sum = 0;
+                for (int c = 0; c < 3; ++c) sum += g.dx[c] * g.dx[c] + g.dy[c] * g.dy[c];
+                return std::sqrt(float(sum));
+            }
+
+#if defined(SEAMCARVING_SSE2)
+            static void Vector(VecGradient const& g, float* out)
+            {
+                VecI half0 = Add32(Madd16(g.dx[0], g.dx[0]), Madd16(g.dy[0], g.dy[0]));
+                VecI half1 = Add32(Madd16(g.dx[1], g.dx[1]), Madd16(g.dy[1], g.dy[1]));
+                StoreSqrt(out, PixelSums(half0, half1));
+            }
+#endif
+        };
+
+        // Summed absolute gradients, no sqrt
+        struct L1Norm
+        {
+            static float Scalar(Gradient const& g)
+            {
+                int sum = 0;
+                for (int c = 0; c < 3; ++c) sum += std::abs(g.dx[c]) + std::abs(g.dy[c]);
+                return float(sum);
+            }
+
+#if defined(SEAMCARVING_SSE2)
+            static void Vector(VecGradient const& g, float* out)
+            {
+                VecI half0 = Madd16(Add16(Abs16(g.dx[0]), Abs16(g.dy[0])), Ones16());
+                VecI half1 = Madd16(Add16(Abs16(g.dx[1]), Abs16(g.dy[1])), Ones16());
+                Store(out, PixelSums(half0, half1));
+            }
+#endif
+        };
+
+        // An energy operator: a gradient policy reduced by a norm policy
+        template <typename GradientPolicy, typename NormPolicy>
+        struct Kernel
+        {
+            static float Scalar(Pixel const* up, Pixel const* row, Pixel const* down, int left, int x, int right)
+            {
+                return NormPolicy::Scalar(GradientPolicy::Scalar(up, row, down, left, x, right));
+            }
+
+#if defined(SEAMCARVING_SSE2)
+            static void Vector(Pixel const* up, Pixel const* row, Pixel const* down, int x, float* out)
+            {
+                NormPolicy::Vector(GradientPolicy::Vector(up, row, down, x), out + x);
+            }
+#endif
+        };
+
+        using L2Kernel = Kernel<Central, L2Norm>;
+
+        // Calls fn with the kernel type for a runtime operator; the switch runs once per call, not per pixel
+        template <typename Fn>
+        void Dispatch(Operator op, Fn&& fn)
+        {
+            switch (op)
+            {
+            case Operator::L1: fn(Kernel<Central, L1Norm>{}); break;
+            case Operator::Sobel: fn(Kernel<Sobel, L2Norm>{}); break;
+            case Operator::Scharr: fn(Kernel<Scharr, L2Norm>{}); break;
+            default: fn(L2Kernel{}); break;
+            }
+        }
+
+        // Energy row y into out: clamp-free interior over raw rows, the border columns clamped separately
+        template <typename Op, bool Vectorised>
+        void ComputeRow(Texture const& texture, int y, float* out)
+        {
+            int width = texture.width;
+            int height = texture.height;
+            int last = width - 1;
+
+            // top and bottom edges reuse their own row as the missing neighbour
+            Pixel const* row = texture.Row(y);
+            Pixel const* up = texture.Row(std::max(y - 1, 0));
+            Pixel const* down = texture.Row(std::min(y + 1, height - 1));
+
+            int x = 1;
+#if defined(SEAMCARVING_SSE2)
+            if constexpr (Vectorised)
+            {
+                for (; x + kLanes < width; x += kLanes)
+                {
+                    Op::Vector(up, row, down, x, out);
+                }
+            }
+#endif
+            for (; x < last; ++x)
+            {
+                out[x] = Op::Scalar(up, row, down, x - 1, x, x + 1);
+            }
+
+            // left and right edges, the only columns where x has to be clamped
+            out[0] = Op::Scalar(up, row, down, 0, 0, std::min(1, last));
+            if (last > 0) out[last] = Op::Scalar(up, row, down, last - 1, last, last);
+        }
+
+        inline float LumaEnergy(int left, int right, int up, int down)
+        {
+            int dx = right - left;
+            int dy = down - up;
+            return std::sqrt(float(dx * dx + dy * dy));
+        }
+
+        // Central-difference L2 over an 8-bit luminance plane: one byte per neighbour instead of four
+        void LuminanceRow(unsigned char const* plane, int width, int height, int stride, int y, float* out)
+        {
+            int last = width - 1;
+
+            unsigned char const* row = plane + y * stride;
+            unsigned char const* up = plane + std::max(y - 1, 0) * stride;
+            unsigned char const* down = plane + std::min(y + 1, height - 1) * stride;
+
+            int x = 1;
+#if defined(SEAMCARVING_AVX2)
+            for (; x + 16 < width; x += 16)
+            {
+                __m256i l = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i const*)(row + x - 1)));
+                __m256i r = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i const*)(row + x + 1)));
+                __m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i const*)(up + x)));
+                __m256i d = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i const*)(down + x)));
+                __m256i dx = _mm256_sub_epi16(r, l);
+                __m256i dy = _mm256_sub_epi16(d, u);
+
+                // interleave (dx, dy) so madd yields dx^2 + dy^2 per pixel,
+                // per 128-bit lane: lo = pixels {0-3 | 8-11}, hi = pixels {4-7 | 12-15}
+                __m256i lo = _mm256_unpacklo_epi16(dx, dy);
+                __m256i hi = _mm256_unpackhi_epi16(dx, dy);
+                __m256 eLo = _mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(lo, lo)));
+                __m256 eHi = _mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(hi, hi)));
+                _mm256_storeu_ps(out + x, _mm256_permute2f128_ps(eLo, eHi, 0x20));
+                _mm256_storeu_ps(out + x + 8, _mm256_permute2f128_ps(eLo, eHi, 0x31));
+            }
+#elif defined(SEAMCARVING_SSE2)
+            __m128i const zero = _mm_setzero_si128();
+            for (; x + 16 < width; x += 16)
+            {
+                __m128i l = _mm_loadu_si128((__m128i const*)(row + x - 1));
+                __m128i r = _mm_loadu_si128((__m128i const*)(row + x + 1));
+                __m128i u = _mm_loadu_si128((__m128i const*)(up + x));
+                __m128i d = _mm_loadu_si128((__m128i const*)(down + x));
+
+                for (int h = 0; h < 2; ++h)
+                {
+                    __m128i dx = h == 0 ? _mm_sub_epi16(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(l, zero))
+                                        : _mm_sub_epi16(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(l, zero));
+                    __m128i dy = h == 0 ? _mm_sub_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(u, zero))
+                                        : _mm_sub_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(u, zero));
+
+                    // interleave (dx, dy) so madd yields dx^2 + dy^2 per pixel
+                    __m128i lo = _mm_unpacklo_epi16(dx, dy);
+                    __m128i hi = _mm_unpackhi_epi16(dx, dy);
+                    _mm_storeu_ps(out + x + 8 * h, _mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(lo, lo))));
+                    _mm_storeu_ps(out + x + 8 * h + 4, _mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(hi, hi))));
+                }
+            }
+#endif
+            for (; x < last; ++x)
+            {
+                out[x] = LumaEnergy(row[x - 1], row[x + 1], up[x], down[x]);
+            }
+
+            out[0] = LumaEnergy(row[0], row[std::min(1, last)], up[0], down[0]);
+            if (last > 0) out[last] = LumaEnergy(row[last - 1], row[last], up[last], down[last]);
+        }
+
+        // The texture's carried luminance plane, or one derived into scratch when it has none
+        unsigned char const* LuminancePlane(Texture const& texture, std::vector<unsigned char>& scratch)
+        {
+            if (texture.HasLuminance()) return texture.luminance.data();
+
+            scratch.resize(texture.pixels.size());
+            for (size_t i = 0; i < texture.pixels.size(); ++i)
+            {
+                scratch[i] = Luminance(texture.pixels[i]);
+            }
+            return scratch.data();
+        }
+
+        void ComputeRows(Texture const& texture, unsigned char const* plane, Grid<float>& energy, Operator op, int begin, int end)
+        {
+            if (op == Operator::Luminance)
+            {
+                for (int y = begin; y < end; ++y)
+                {
+                    LuminanceRow(plane, texture.width, texture.height, texture.stride, y, energy.Row(y));
+                }
+                return;
+            }
+
+            Dispatch(op, [&](auto kernel)
+            {
+                for (int y = begin; y < end; ++y)
+                {
+                    ComputeRow<decltype(kernel), true>(texture, y, energy.Row(y));
+                }
+            });
+        }
+
+        // One pyramid step: each output pixel is the rounded mean of a 2x2 block, the last
+        // column / row repeated when the size is odd
+        Texture HalveTexture(Texture const& texture)
+        {
+            Texture half{};
+            half.Allocate((texture.width + 1) / 2, (texture.height + 1) / 2);
+
+            int pairs = texture.width / 2;
+            for (int y = 0; y < half.height; ++y)
+            {
+                Pixel const* top = texture.Row(2 * y);
+                Pixel const* bottom = texture.Row(std::min(2 * y + 1, texture.height - 1));
+                Pixel* out = half.Row(y);
+
+                int x = 0;
+#if defined(SEAMCARVING_SSE2)
+                __m128i const zero = _mm_setzero_si128();
+                __m128i const two = _mm_set1_epi16(2);
+
+                // 8 input pixels (two registers per row) become 4 output pixels
+                auto PairSums = [&](__m128i a, __m128i b)
+                {
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                    lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                    hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                    return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+                };
+
+                for (; x + 4 <= pairs; x += 4)
+                {
+                    __m128i const* a = (__m128i const*)(top + 2 * x);
+                    __m128i const* b = (__m128i const*)(bottom + 2 * x);
+                    __m128i first = PairSums(_mm_loadu_si128(a), _mm_loadu_si128(b));
+                    __m128i second = PairSums(_mm_loadu_si128(a + 1), _mm_loadu_si128(b + 1));
+                    _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(first, second));
+                }
+#endif
+                for (; x < half.width; ++x)
+                {
+                    int left = 2 * x;
+                    int right = std::min(left + 1, texture.width - 1);
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        int sum = top[left].data[c] + top[right].data[c] + bottom[left].data[c] + bottom[right].data[c];
+                        out[x].data[c] = static_cast<unsigned char>((sum + 2) >> 2);
+                    }
+                }
+            }
+
+            return half;
+        }
+
+        // The two coarse samples either side of a full-resolution pixel centre and the blend weight
+        struct BilinearTap
+        {
+            int first;
+            int second;
+            float weight;
+        };
+
+        std::vector<BilinearTap> BilinearTaps(int size, int coarseSize, int factor)
+        {
+            std::vector<BilinearTap> taps(size);
+            for (int i = 0; i < size; ++i)
+            {
+                float u = std::clamp((i + 0.5f) / factor - 0.5f, 0.0f, float(coarseSize - 1));
+                int first = static_cast<int>(u);
+                taps[i] = { first, std::min(first + 1, coarseSize - 1), u - first };
+            }
+            return taps;
+        }
+    }
+
+    Grid<float> ComputeScalar(Texture const& texture)
+    {
+        Grid<float> energy(texture.width, texture.height, 0.0f);
+
+        for (int y = 0; y < texture.height; ++y)
+        {
+            for (int x = 0; x < texture.width; ++x)
+            {
+                Pixel left = texture.GetPixel(x - 1, y);
+                Pixel right = texture.GetPixel(x + 1, y);
+                Pixel up = texture.GetPixel(x, y - 1);
+                Pixel down = texture.GetPixel(x, y + 1);
+
+                float dx = std::pow(float(right.r) - float(left.r), 2) +
+                    std::pow(float(right.g) - float(left.g), 2) +
+                    std::pow(float(right.b) - float(left.b), 2);
+
+                float dy = std::pow(float(down.r) - float(up.r), 2) +
+                    std::pow(float(down.g) - float(up.g), 2) +
+                    std::pow(float(down.b) - float(up.b), 2);
+
+                energy(x, y) = std::sqrt(dx + dy);
+            }
+        }
+
+        return energy;
+    }
+
+    Grid<float> ComputeSplit(Texture const& texture)
+    {
+        Grid<float> energy(texture.width, texture.height, 0.0f);
+        for (int y = 0; y < texture.height; ++y)
+        {
+            ComputeRow<L2Kernel, false>(texture, y, energy.Row(y));
+        }
+        return energy;
+    }
+
+    Grid<float> ComputeSIMD(Texture const& texture, Operator op)
+    {
+        Grid<float> energy(texture.width, texture.height, 0.0f);
+        std::vector<unsigned char> scratch;
+        unsigned char const* plane = op == Operator::Luminance ? LuminancePlane(texture, scratch) : nullptr;
+
+        ComputeRows(texture, plane, energy, op, 0, texture.height);
+        return energy;
+    }
+
+    Grid<float> ComputeParallel(Texture const& texture, Operator op, int workers)
+    {
+        Grid<float> energy(texture.width, texture.height, 0.0f);
+        std::vector<unsigned char> scratch;
+        unsigned char const* plane = op == Operator::Luminance ? LuminancePlane(texture, scratch) : nullptr;
+
+        if (texture.width * texture.height < kParallelThreshold)
+        {
+            ComputeRows(texture, plane, energy, op, 0, texture.height);
+            return energy;
+        }
+
+        // each output row reads only input rows y-1..y+1, so bands never write the same memory
+        Parallel::ForBands(texture.height, workers, [&](int begin, int end)
+        {
+            ComputeRows(texture, plane, energy, op, begin, end);
+        });
+
+        return energy;
+    }
+
+    Texture Downsample(Texture const& texture, int factor)
+    {
+        if (factor <= 1) return texture;
+
+        Texture level = HalveTexture(texture);
+        for (factor /= 2; factor > 1; factor /= 2)
+        {
+            level = HalveTexture(level);
+        }
+
+        if (texture.HasLuminance()) level.BuildLuminance();
+        return level;
+    }
+
+    Grid<float> ComputePyramid(Texture const& texture, int factor, Operator op, int workers)
+    {
+        if (factor <= 1) return ComputeParallel(texture, op, workers);
+
+        Texture coarse = Downsample(texture, factor);
+        Grid<float> coarseEnergy = ComputeParallel(coarse, op, workers);
+
+        std::vector<BilinearTap> columns = BilinearTaps(texture.width, coarse.width, factor);
+        std::vector<BilinearTap> rows = BilinearTaps(texture.height, coarse.height, factor);
+
+        // widen every coarse row once, then each output row is a contiguous blend of two of them
+        Grid<float> widened(texture.width, coarse.height);
+        for (int cy = 0; cy < coarse.height; ++cy)
+        {
+            float const* src = coarseEnergy.Row(cy);
+            float* dst = widened.Row(cy);
+            for (int x = 0; x < texture.width; ++x)
+            {
+                BilinearTap tap = columns[x];
+                dst[x] = src[tap.first] + (src[tap.second] - src[tap.first]) * tap.weight;
+            }
+        }
+
+        Grid<float> energy(texture.width, texture.height);
+        for (int y = 0; y < texture.height; ++y)
+        {
+            BilinearTap tap = rows[y];
+            float const* top = widened.Row(tap.first);
+            float const* bottom = widened.Row(tap.second);
+            float* out = energy.Row(y);
+            for (int x = 0; x < texture.width; ++x)
+            {
+                out[x] = top[x] + (bottom[x] - top[x]) * tap.weight;
+            }
+        }
+
+        return energy;
+    }
+
+    void ComputeRow(Texture const& texture, int y, float* out, Operator op)
+    {
+        if (op == Operator::Luminance)
+        {
+            if (texture.HasLuminance())
+            {
+                LuminanceRow(texture.luminance.data(), texture.width, texture.height, texture.stride, y, out);
+                return;
+            }
+
+            // derive luma for the three rows involved only, stacked as a 3-row plane
+            int width = texture.width;
+            std::vector<unsigned char> rows(3 * width);
+            int sources[3] = { std::max(y - 1, 0), y, std::min(y + 1, texture.height - 1) };
+            for (int i = 0; i < 3; ++i)
+            {
+                Pixel const* row = texture.Row(sources[i]);
+                for (int x = 0; x < width; ++x) rows[i * width + x] = Luminance(row[x]);
+            }
+            LuminanceRow(rows.data(), width, 3, width, 1, out);
+            return;
+        }
+
+        Dispatch(op, [&](auto kernel)
+        {
+            ComputeRow<decltype(kernel), true>(texture, y, out);
+        });
+    }
+
+    void ComputeSpan(Texture const& texture, Grid<float>& energy, int y, int begin, int end, Operator op)
+    {
+        begin = std::max(begin, 0);
+        ComputeSpan(texture, y, begin, end, energy.Row(y) + begin, op);
+    }
+
+    void ComputeSpan(Texture const& texture, int y, int begin, int end, float* span, Operator op)
+    {
+        int width = texture.width;
+        begin = std::max(begin, 0);
+        end = std::min(end, width);
+
+        Pixel const* row = texture.Row(y);
+        Pixel const* up = texture.Row(std::max(y - 1, 0));
+        Pixel const* down = texture.Row(std::min(y + 1, texture.height - 1));
+
+        if (op == Operator::Luminance)
+        {
+            // a handful of pixels, so derive luma on the fly if the plane is not carried
+            auto luma = [&](int px, int py)
+            {
+                int index = py * texture.stride + px;
+                return texture.HasLuminance() ? int(texture.luminance[index]) : int(Luminance(texture.pixels[index]));
+            };
+
+            int above = std::max(y - 1, 0);
+            int below = std::min(y + 1, texture.height - 1);
+            for (int x = begin; x < end; ++x)
+            {
+                span[x - begin] = LumaEnergy(luma(std::max(x - 1, 0), y), luma(std::min(x + 1, width - 1), y), luma(x, above), luma(x, below));
+            }
+            return;
+        }
+
+        Dispatch(op, [&](auto kernel)
+        {
+            using Op = decltype(kernel);
+            for (int x = begin; x < end; ++x)
+            {
+                span[x - begin] = Op::Scalar(up, row, down, std::max(x - 1, 0), x, std::min(x + 1, width - 1));
+            }
+        });
+    }
+
+    Grid<uint16_t> Quantize(Grid<float> const& energy, float* outScale)
+    {
+        float maxEnergy = 0.0f;
+        for (float e : energy.data) maxEnergy = std::max(maxEnergy, e);
+
+        float scale = maxEnergy > 0.0f ? 65535.0f / maxEnergy : 1.0f;
+        if (outScale) *outScale = scale;
+
+        Grid<uint16_t> quantized(energy.width, energy.height);
+        for (size_t i = 0; i < energy.data.size(); ++i)
+        {
+            int q = static_cast<int>(energy.data[i] * scale + 0.5f);
+            quantized.data[i] = static_cast<uint16_t>(std::min(q, 65535));
+        }
+
+        return quantized;
+    }
+
+    float MaxEnergy(Operator op)
+    {
+        // every gradient component is at most the sum of the positive kernel weights times 255,
+        // with three colour channels in x and y
+        switch (op)
+        {
+        case Operator::L1: return 6.0f * 255.0f;
+        case Operator::Sobel: return 4.0f * 255.0f * std::sqrt(6.0f);
+        case Operator::Scharr: return 16.0f * 255.0f * std::sqrt(6.0f);
+        case Operator::Luminance: return 255.0f * std::sqrt(2.0f);
+        default: return 255.0f * std::sqrt(6.0f);
+        }
+    }
+
+    Grid<uint16_t> ComputeQuantized(Texture const& texture, Operator op, float* outScale)
+    {
+        float scale = 65535.0f / MaxEnergy(op);
+        if (outScale) *outScale = scale;
+
+        Grid<uint16_t> quantized(texture.width, texture.height);
+        std::vector<float> row(texture.width);
+
+        for (int y = 0; y < texture.height; ++y)
+        {
+            ComputeRow(texture, y, row.data(), op);
+            uint16_t* out = quantized.Row(y);
+            for (int x = 0; x < texture.width; ++x)
+            {
+                int q = static_cast<int>(row[x] * scale + 0.5f);
+                out[x] = static_cast<uint16_t>(std::min(q, 65535));
+            }
+        }
+
+        return quantized;
+    }
+
+    char const* OperatorName(Operator op)
+    {
+        switch (op)
+        {
+        case Operator::L1: return "L1 Gradient";
+        case Operator::Sobel: return "Sobel";
+        case Operator::Scharr: return "Scharr";
+        case Operator::Luminance: return "Luminance L2";
+        default: return "L2 Gradient";
+        }
+    }
+
+    char const* SIMDLevel()
+    {
+#if defined(SEAMCARVING_AVX2)
+        return "AVX2";
+#elif defined(SEAMCARVING_SSE2)
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace Energy
+{
+	// Energy operators, each compiled into its own inlined kernel (no per-pixel dispatch)
+	enum class Operator
+	{
+		L2,        // central difference, sqrt(dx^2 + dy^2), the original energy
+		L1,        // central difference, |dx| + |dy|, no sqrt
+		Sobel,     // 3x3 Sobel, L2 magnitude
+		Scharr,    // 3x3 Scharr, L2 magnitude
+		Luminance, // central difference L2 on the 8-bit luminance plane carried by the texture
+		Count
+	};
+
+	char const* OperatorName(Operator op);
+
+	// Reference dual-gradient energy: four clamped GetPixel reads and float pow per pixel
+	Grid<float> ComputeScalar(Texture const& texture);
+
+	// Scalar L2 energy split into a clamp-free interior loop over raw rows and a clamped border ring
+	Grid<float> ComputeSplit(Texture const& texture);
+
+	// Vectorised energy (4 pixels per iteration on SSE2, 8 on AVX2), scalar without SSE2.
+	// Tolerance against the scalar kernels is exact (0 ULP): squared differences are summed in
+	// integers before a single conversion to float and sqrt, as the scalar path does.
+	Grid<float> ComputeSIMD(Texture const& texture, Operator op = Operator::L2);
+
+	// Images smaller than this many pixels are not worth the thread start-up cost
+	constexpr int kParallelThreshold = 512 * 512;
+
+	// ComputeSIMD spread over horizontal row bands, one per worker (0 = hardware threads).
+	// The result is identical to the serial kernel; below kParallelThreshold it runs serially.
+	Grid<float> ComputeParallel(Texture const& texture, Operator op = Operator::L2, int workers = 0);
+
+	// Pyramid level `factor` (a power of two) times smaller in each direction, built by repeated 2x2
+	// box filtering. The luminance plane is rebuilt if the source carries one.
+	Texture Downsample(Texture const& texture, int factor);
+
+	// Energy computed on a Downsample level and bilinearly upsampled to full size, for large inputs
+	// where full-resolution gradients are not needed to pick seams
+	Grid<float> ComputePyramid(Texture const& texture, int factor, Operator op = Operator::L2, int workers = 0);
+
+	// Energy of row y written to out[0, width), the same values ComputeSIMD produces for that row,
+	// so callers can stream energy through a pass without holding a full grid
+	void ComputeRow(Texture const& texture, int y, float* out, Operator op = Operator::L2);
+
+	// Recompute energy[y][begin, end) in place from the texture, clamping only at the image border
+	void ComputeSpan(Texture const& texture, Grid<float>& energy, int y, int begin, int end, Operator op = Operator::L2);
+	// Same values written to span[0, end - begin), for callers that only hold a band of each row
+	void ComputeSpan(Texture const& texture, int y, int begin, int end, float* span, Operator op = Operator::L2);
+
+	// Fixed-point copy of an energy grid for the integer DP, scaled so the largest value maps to 65535.
+	// The scale used is written to outScale when given (float energy ~= quantized / scale).
+	Grid<uint16_t> Quantize(Grid<float> const& energy, float* outScale = nullptr);
+
+	// Largest value an operator can produce on 8-bit RGB (or luminance) input
+	float MaxEnergy(Operator op);
+
+	// Fixed-point energy for the integer DP produced row by row through ComputeRow, scaled so
+	// MaxEnergy(op) maps to 65535: only one float row is alive, no float grid is written and re-read.
+	// The fixed bound gives a coarser step than Quantize on images that do not reach it.
+	Grid<uint16_t> ComputeQuantized(Texture const& texture, Operator op = Operator::L2, float* outScale = nullptr);
+
+	// Instruction set ComputeSIMD was compiled for
+	char const* SIMDLevel();
+}
@@ -0,0 +1,118 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+#include "simd.hpp"
+#include "transpose.hpp"
+
+namespace DP
+{
+    namespace
+    {
+#if defined(SEAMCARVING_SSE2) && !defined(SEAMCARVING_AVX2)
+        // SSE2 has no unsigned 32-bit min, compare with the sign bit flipped instead
+        inline __m128i MinU32(__m128i a, __m128i b)
+        {
+            __m128i const bias = _mm_set1_epi32(int(0x80000000u));
+            __m128i greater = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+            return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+        }
+#endif
+
+        // cur[x] = energy[x] + min(prev[x - 1], prev[x], prev[x + 1]), edges handled outside the vector loop.
+        // Sums cannot wrap: FindSeam scales energy down so that a column of `height` rows fits in uint32.
+        void UpdateRow(uint32_t const* prev, uint16_t const* energy, uint32_t* cur, int width)
+        {
+            int last = width - 1;
+            if (width == 1)
+            {
+                cur[0] = prev[0] + energy[0];
+                return;
+            }
+
+            int x = 1;
+#if defined(SEAMCARVING_AVX2)
+            for (; x + 8 < width; x += 8)
+            {
+                __m256i left = _mm256_loadu_si256((__m256i const*)(prev + x - 1));
+                __m256i up = _mm256_loadu_si256((__m256i const*)(prev + x));
+                __m256i right = _mm256_loadu_si256((__m256i const*)(prev + x + 1));
+                __m256i best = _mm256_min_epu32(_mm256_min_epu32(left, up), right);
+                __m256i e = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(energy + x)));
+                _mm256_storeu_si256((__m256i*)(cur + x), _mm256_add_epi32(best, e));
+            }
+#elif defined(SEAMCARVING_SSE2)
+            for (; x + 4 < width; x += 4)
+            {
+                __m128i left = _mm_loadu_si128((__m128i const*)(prev + x - 1));
+                __m128i up = _mm_loadu_si128((__m128i const*)(prev + x));
+                __m128i right = _mm_loadu_si128((__m128i const*)(prev + x + 1));
+                __m128i best = MinU32(MinU32(left, up), right);
+                __m128i e = _mm_unpacklo_epi16(_mm_loadl_epi64((__m128i const*)(energy + x)), _mm_setzero_si128());
+                _mm_storeu_si128((__m128i*)(cur + x), _mm_add_epi32(best, e));
+            }
+#endif
+            for (; x < last; ++x)
+            {
+                cur[x] = energy[x] + std::min(std::min(prev[x - 1], prev[x]), prev[x + 1]);
+            }
+
+            cur[0] = energy[0] + std::min(prev[0], prev[1]);
+            cur[last] = energy[last] + std::min(prev[last - 1], prev[last]);
+        }
+
+        // Vertical seam through a row-major integer energy grid, same tie-breaking as the float DP
+        std::vector<int> FindSeam(Grid<uint16_t> const& energy)
+        {
+            int width = energy.width;
+            int height = energy.height;
+
+            // 65535 * height overflows uint32 beyond 65537 rows (horizontal seams of very wide panoramas
+            // run on the transpose): drop low bits until a full column fits, trading precision for
+            // correct sums instead of silently wrapping
+            int shift = 0;
+            while (uint64_t(65535u >> shift) * uint64_t(height) > std::numeric_limits<uint32_t>::max()) ++shift;
+            Grid<uint16_t> scaled(shift > 0 ? width : 0, shift > 0 ? height : 0);
+            if (shift > 0)
+            {
+                for (size_t i = 0; i < energy.data.size(); ++i) scaled.data[i] = uint16_t(energy.data[i] >> shift);
+            }
+            Grid<uint16_t> const& source = shift > 0 ? scaled : energy;
+
+            Grid<uint32_t> cumulative(width, height);
+            std::copy(source.Row(0), source.Row(0) + width, cumulative.Row(0));
+
+            for (int y = 1; y < height; ++y)
+            {
+                UpdateRow(cumulative.Row(y - 1), source.Row(y), cumulative.Row(y), width);
+            }
+
+            std::vector<int> seam(height);
+            uint32_t const* bottom = cumulative.Row(height - 1);
+            seam[height - 1] = static_cast<int>(std::min_element(bottom, bottom + width) - bottom);
+
+            for (int y = height - 2; y >= 0; --y)
+            {
+                uint32_t const* row = cumulative.Row(y);
+                int prevX = seam[y + 1];
+                int bestX = prevX;
+
+                if (prevX > 0 && row[prevX - 1] < row[bestX]) bestX = prevX - 1;
+                if (prevX < width - 1 && row[prevX + 1] < row[bestX]) bestX = prevX + 1;
+
+                seam[y] = bestX;
+            }
+
+            return seam;
+        }
+    }
+
+    std::vector<int> FindVerticalSeamFixed(Grid<uint16_t> const& energy)
+    {
+        return FindSeam(energy);
+    }
+
+    std::vector<int> FindHorizontalSeamFixed(Grid<uint16_t> const& energy)
+    {
+        // a horizontal seam is a vertical seam of the transpose, which keeps the row update contiguous
+        return FindSeam(Transposed(energy));
+    }
+}
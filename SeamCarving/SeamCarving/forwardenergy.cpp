@@ -0,0 +1,191 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    namespace
+    {
+        // Sum of absolute RGB differences, the edge strength forward energy charges for a new edge
+        inline float ColorDistance(Pixel a, Pixel b)
+        {
+            return float(std::abs(int(a.r) - int(b.r)) + std::abs(int(a.g) - int(b.g)) + std::abs(int(a.b) - int(b.b)));
+        }
+
+        // The image seen as `count` lines of `length` pixels, walked along the seam direction.
+        // Vertical seams use rows (pixelStride 1), horizontal seams use columns (pixelStride width).
+        struct Lines
+        {
+            Pixel const* base;
+            int length;
+            int count;
+            int pixelStride;
+            int lineStride;
+
+            Pixel At(int line, int i) const
+            {
+                return base[line * lineStride + i * pixelStride];
+            }
+        };
+
+        // Costs of the edges created by removing pixel i of a line whose previous line is line - 1:
+        // C_U joins the two neighbours, C_L / C_R additionally join the previous line to the left / right neighbour
+        struct ForwardCosts
+        {
+            std::vector<float> up, left, right;
+
+            explicit ForwardCosts(int length) : up(length), left(length), right(length)
+            {
+
+            }
+
+            void At(Lines const& lines, int line, int i, float& cu, float& cl, float& cr) const
+            {
+                int previous = std::max(line - 1, 0);
+                Pixel l = lines.At(line, std::max(i - 1, 0));
+                Pixel r = lines.At(line, std::min(i + 1, lines.length - 1));
+                Pixel p = lines.At(previous, i);
+
+                cu = ColorDistance(r, l);
+                cl = cu + ColorDistance(p, l);
+                cr = cu + ColorDistance(p, r);
+            }
+
+            void Compute(Lines const& lines, int line)
+            {
+                int last = lines.length - 1;
+                Pixel const* cur = lines.base + line * lines.lineStride;
+                Pixel const* prev = lines.base + std::max(line - 1, 0) * lines.lineStride;
+                int stride = lines.pixelStride;
+
+                // clamp-free interior, the compiler can vectorise this for contiguous rows
+                for (int i = 1; i < last; ++i)
+                {
+                    Pixel l = cur[(i - 1) * stride];
+                    Pixel r = cur[(i + 1) * stride];
+                    Pixel p = prev[i * stride];
+
+                    float cu = ColorDistance(r, l);
+                    up[i] = cu;
+                    left[i] = cu + ColorDistance(p, l);
+                    right[i] = cu + ColorDistance(p, r);
+                }
+
+                At(lines, line, 0, up[0], left[0], right[0]);
+                if (last > 0) At(lines, line, last, up[last], left[last], right[last]);
+            }
+        };
+
+        // Forward-energy DP over the lines; cumulative costs are fused with the cost computation so
+        // no energy grid is built. Returns, for every line, the index of the removed pixel.
+        std::vector<int> FindForwardSeam(Lines const& lines)
+        {
+            int length = lines.length;
+            int count = lines.count;
+            int last = length - 1;
+
+            Grid<float> cumulative(length, count);
+            ForwardCosts costs(length);
+
+            // the first line has no predecessor, only the edge joining its neighbours is created
+            costs.Compute(lines, 0);
+            std::copy(costs.up.begin(), costs.up.end(), cumulative.Row(0));
+
+            for (int line = 1; line < count; ++line)
+            {
+                costs.Compute(lines, line);
+                float const* prev = cumulative.Row(line - 1);
+                float* cur = cumulative.Row(line);
+
+                if (length == 1)
+                {
+                    cur[0] = prev[0] + costs.up[0];
+                    continue;
+                }
+
+                for (int i = 1; i < last; ++i)
+                {
+                    cur[i] = std::min(std::min(prev[i - 1] + costs.left[i], prev[i] + costs.up[i]), prev[i + 1] + costs.right[i]);
+                }
+
+                cur[0] = std::min(prev[0] + costs.up[0], prev[1] + costs.right[0]);
+                cur[last] = std::min(prev[last - 1] + costs.left[last], prev[last] + costs.up[last]);
+            }
+
+            std::vector<int> seam(count);
+
+            float const* bottom = cumulative.Row(count - 1);
+            seam[count - 1] = static_cast<int>(std::min_element(bottom, bottom + length) - bottom);
+
+            // only the three costs on the path are recomputed while backtracking
+            for (int line = count - 1; line > 0; --line)
+            {
+                int i = seam[line];
+                float const* prev = cumulative.Row(line - 1);
+                float cu, cl, cr;
+                costs.At(lines, line, i, cu, cl, cr);
+
+                int best = i;
+                float bestCost = prev[i] + cu;
+
+                if (i > 0 && prev[i - 1] + cl < bestCost)
+                {
+                    best = i - 1;
+                    bestCost = prev[i - 1] + cl;
+                }
+
+                if (i < last && prev[i + 1] + cr < bestCost)
+                {
+                    best = i + 1;
+                    bestCost = prev[i + 1] + cr;
+                }
+
+                seam[line - 1] = best;
+            }
+
+            return seam;
+        }
+
+        // Forward cost of a given seam: the edges its removal creates, the same sum the DP minimises
+        float ForwardSeamCost(Lines const& lines, std::vector<int> const& seam)
+        {
+            ForwardCosts costs(0);
+            float total = 0.0f;
+
+            for (int line = 0; line < lines.count; ++line)
+            {
+                int i = seam[line];
+                float cu, cl, cr;
+                costs.At(lines, line, i, cu, cl, cr);
+
+                int previous = line > 0 ? seam[line - 1] : i;
+                total += previous < i ? cl : previous > i ? cr : cu;
+            }
+
+            return total;
+        }
+    }
+
+    std::vector<int> FindVerticalSeamForward(Texture const& texture)
+    {
+        Lines rows{ texture.pixels.data(), texture.width, texture.height, 1, texture.stride };
+        return FindForwardSeam(rows);
+    }
+
+    std::vector<int> FindHorizontalSeamForward(Texture const& texture)
+    {
+        Lines columns{ texture.pixels.data(), texture.height, texture.width, texture.stride, 1 };
+        return FindForwardSeam(columns);
+    }
+
+    float CalculateVerticalSeamForwardEnergy(Texture const& texture, std::vector<int> const& seam)
+    {
+        Lines rows{ texture.pixels.data(), texture.width, texture.height, 1, texture.stride };
+        return ForwardSeamCost(rows, seam);
+    }
+
+    float CalculateHorizontalSeamForwardEnergy(Texture const& texture, std::vector<int> const& seam)
+    {
+        Lines columns{ texture.pixels.data(), texture.height, texture.width, texture.stride, 1 };
+        return ForwardSeamCost(columns, seam);
+    }
+}
@@ -0,0 +1,98 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    namespace
+    {
+        // Steps stored as 2-bit codes (step + 1), four pixels per byte, low bits first
+        struct PackedSteps
+        {
+            int rowBytes;
+            std::vector<unsigned char> codes;
+
+            PackedSteps(int width, int height) : rowBytes((width + 3) / 4), codes(rowBytes * height)
+            {
+
+            }
+
+            void PackRow(int y, signed char const* steps, int width)
+            {
+                unsigned char* row = codes.data() + y * rowBytes;
+                for (int x = 0; x < width; ++x)
+                {
+                    row[x >> 2] |= static_cast<unsigned char>((steps[x] + 1) << ((x & 3) * 2));
+                }
+            }
+
+            int Step(int y, int x) const
+            {
+                return ((codes[y * rowBytes + (x >> 2)] >> ((x & 3) * 2)) & 3) - 1;
+            }
+        };
+
+        int MinIndex(float const* line, int length)
+        {
+            return static_cast<int>(std::min_element(line, line + length) - line);
+        }
+
+        std::vector<int> Backtrack(PackedSteps const& steps, int count, int last)
+        {
+            std::vector<int> seam(count);
+            seam[count - 1] = last;
+            for (int i = count - 1; i > 0; --i)
+            {
+                seam[i - 1] = seam[i] + steps.Step(i, seam[i]);
+            }
+            return seam;
+        }
+    }
+
+    std::vector<int> FindVerticalSeamLowMemory(Grid<float> const& energy)
+    {
+        int width = energy.width;
+        int height = energy.height;
+
+        PaddedGrid<float> lines(width, 2, std::numeric_limits<float>::infinity());
+        float* previous = lines.Row(0);
+        float* current = lines.Row(1);
+        std::copy(energy.Row(0), energy.Row(0) + width, previous);
+        std::vector<signed char> rowSteps(width);
+        PackedSteps steps(width, height);
+
+        for (int y = 1; y < height; ++y)
+        {
+            RelaxPaddedRow(previous, energy.Row(y), current, rowSteps.data(), width);
+            steps.PackRow(y, rowSteps.data(), width);
+            std::swap(previous, current);
+        }
+
+        return Backtrack(steps, height, MinIndex(previous, width));
+    }
+
+    std::vector<int> FindHorizontalSeamLowMemory(Grid<float> const& energy)
+    {
+        int width = energy.width;
+        int height = energy.height;
+
+        // no transposed copy here, each energy column is gathered into a single scratch column
+        PaddedGrid<float> lines(height, 2, std::numeric_limits<float>::infinity());
+        float* previous = lines.Row(0);
+        float* current = lines.Row(1);
+        std::vector<float> column(height);
+        std::vector<signed char> columnSteps(height);
+        PackedSteps steps(height, width);
+
+        for (int y = 0; y < height; ++y) previous[y] = energy.Row(y)[0];
+
+        for (int x = 1; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y) column[y] = energy.Row(y)[x];
+            RelaxPaddedRow(previous, column.data(), current, columnSteps.data(), height);
+            steps.PackRow(x, columnSteps.data(), height);
+            std::swap(previous, current);
+        }
+
+        return Backtrack(steps, width, MinIndex(previous, height));
+    }
+}
@@ -0,0 +1,132 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    namespace
+    {
+        // Vertical seam restricted to columns [first[y], first[y] + band) of every row, guided by the seam
+        // one pyramid level up. Energy is computed only inside the band and each band is relaxed with
+        // RelaxSpan on rolling full-width rows, cells outside the band of the previous row set to +inf;
+        // only the steps are kept, band-relative. Same tie-breaking as FindVerticalSeam.
+        std::vector<int> FindBandedSeam(Texture const& texture, std::vector<int> const& coarse, int bandRadius, Energy::Operator op)
+        {
+            int width = texture.width;
+            int height = texture.height;
+            int coarseHeight = static_cast<int>(coarse.size());
+
+            // coarse column s covers fine columns 2s and 2s + 1, the band extends bandRadius past both
+            int band = std::min(2 * bandRadius + 2, width);
+            std::vector<int> first(height);
+            for (int y = 0; y < height; ++y)
+            {
+                int center = 2 * coarse[std::min(y / 2, coarseHeight - 1)];
+                first[y] = std::clamp(center - bandRadius, 0, width - band);
+            }
+
+            float const unreachable = std::numeric_limits<float>::infinity();
+            std::vector<float> energy(width);
+            std::vector<float> previous(width);
+            std::vector<float> current(width);
+            std::vector<signed char> stepRow(width);
+            Grid<signed char> steps(band, height);
+
+            Energy::ComputeSpan(texture, 0, first[0], first[0] + band, previous.data() + first[0], op);
+
+            for (int y = 1; y < height; ++y)
+            {
+                int begin = first[y];
+                int end = begin + band;
+                int previousBegin = first[y - 1];
+                int previousEnd = previousBegin + band;
+
+                // RelaxSpan reads one column either side of the band, outside the previous band is unreachable
+                int lowest = std::max(begin - 1, 0);
+                int highest = std::min(end + 1, width);
+                if (lowest < previousBegin) std::fill(previous.begin() + lowest, previous.begin() + std::min(previousBegin, highest), unreachable);
+                if (highest > previousEnd) std::fill(previous.begin() + std::max(previousEnd, lowest), previous.begin() + highest, unreachable);
+
+                Energy::ComputeSpan(texture, y, begin, end, energy.data() + begin, op);
+                RelaxSpan(previous.data(), energy.data(), current.data(), stepRow.data(), width, begin, end);
+                std::copy(stepRow.begin() + begin, stepRow.begin() + end, steps.Row(y));
+                std::swap(previous, current);
+            }
+
+            std::vector<int> seam(height);
+            float const* bottom = previous.data() + first[height - 1];
+            seam[height - 1] = first[height - 1] + static_cast<int>(std::min_element(bottom, bottom + band) - bottom);
+
+            for (int y = height - 1; y > 0; --y)
+            {
+                seam[y - 1] = seam[y] + steps.Row(y)[seam[y] - first[y]];
+            }
+
+            return seam;
+        }
+    }
+
+    void SeamPyramid::Build(Texture const& texture, int count, int bandRadius)
+    {
+        levels.clear();
+        if (count <= 1) return;
+
+        // each level halves the one below while it stays wider than a band
+        bandRadius = std::max(bandRadius, 1);
+        levels.reserve(count - 1);
+        for (int level = 1; level < count; ++level)
+        {
+            Texture const& finer = level == 1 ? texture : levels.back();
+            if (finer.width / 2 <= 2 * bandRadius + 2 || finer.height < 2) break;
+            levels.push_back(Energy::Downsample(finer, 2));
+        }
+    }
+
+    void SeamPyramid::RemoveVerticalSeam(Texture const& texture, std::vector<int> const& seam)
+    {
+        std::vector<int> finerSeam = seam;
+        int finerWidth = texture.width;
+
+        for (Texture& level : levels)
+        {
+            // a level is (finer width + 1) / 2 wide, so it only loses a column every other seam
+            if (level.width == (finerWidth + 1) / 2 || level.width <= 1) break;
+
+            // coarse row r covers finer rows 2r and 2r + 1, coarse column c finer columns 2c and 2c + 1
+            int finerHeight = static_cast<int>(finerSeam.size());
+            std::vector<int> coarse(level.height);
+            for (int r = 0; r < level.height; ++r)
+            {
+                coarse[r] = std::min(finerSeam[std::min(2 * r, finerHeight - 1)] / 2, level.width - 1);
+            }
+
+            CompactVerticalSeam(level, coarse);
+            finerSeam = std::move(coarse);
+            finerWidth = level.width;
+        }
+    }
+
+    std::vector<int> FindVerticalSeamMultiresolution(Texture const& texture, SeamPyramid const& pyramid, int bandRadius, Energy::Operator op)
+    {
+        bandRadius = std::max(bandRadius, 1);
+        std::vector<Texture> const& levels = pyramid.levels;
+
+        if (levels.empty()) return FindVerticalSeam(ComputeEnergy(texture, op));
+
+        std::vector<int> seam = FindVerticalSeam(ComputeEnergy(levels.back(), op));
+
+        for (int level = static_cast<int>(levels.size()) - 2; level >= -1; --level)
+        {
+            Texture const& finer = level < 0 ? texture : levels[level];
+            seam = FindBandedSeam(finer, seam, bandRadius, op);
+        }
+
+        return seam;
+    }
+
+    std::vector<int> FindVerticalSeamMultiresolution(Texture const& texture, int levels, int bandRadius, Energy::Operator op)
+    {
+        SeamPyramid pyramid;
+        pyramid.Build(texture, levels, bandRadius);
+        return FindVerticalSeamMultiresolution(texture, pyramid, bandRadius, op);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <mutex>
+#include <condition_variable>
+
+namespace Parallel
+{
+	// Worker count to use when the caller asks for 0
+	inline int HardwareWorkers()
+	{
+		return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+
+	// Reusable barrier for a fixed number of threads (std::barrier needs C++20)
+	class Barrier
+	{
+	public:
+		explicit Barrier(int count) : count(count)
+		{
+
+		}
+
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			int arrivedGeneration = generation;
+			if (++waiting == count)
+			{
+				waiting = 0;
+				++generation;
+				condition.notify_all();
+				return;
+			}
+			condition.wait(lock, [&]() { return generation != arrivedGeneration; });
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable condition;
+		int count;
+		int waiting = 0;
+		int generation = 0;
+	};
+
+	// Run a on the calling thread and b on a second one, returning once both are done.
+	// With a single hardware thread both run on the caller, a first.
+	template <typename A, typename B>
+	void Invoke(A&& a, B&& b)
+	{
+		if (HardwareWorkers() < 2)
+		{
+			a();
+			b();
+			return;
+		}
+
+		std::thread thread([&b]() { b(); });
+		a();
+		thread.join();
+	}
+
+	// Split [0, count) into contiguous bands and call fn(begin, end) once per band,
+	// one band per worker. The calling thread runs the first band and joins the rest.
+	template <typename Fn>
+	void ForBands(int count, int workers, Fn&& fn)
+	{
+		if (workers <= 0) workers = HardwareWorkers();
+		workers = std::clamp(workers, 1, std::max(count, 1));
+
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1);
+
+		for (int i = 1; i < workers; ++i)
+		{
+			int begin = count * i / workers;
+			int end = count * (i + 1) / workers;
+			threads.emplace_back([&fn, begin, end]() { fn(begin, end); });
+		}
+
+		fn(0, count / workers);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+}
@@ -1,99 +1,206 @@
 #include "../pch.h"
 #include "seamcarvingdp.hpp"
+#include "energy.hpp"
+#include "simd.hpp"
+#include "transpose.hpp"
 
 namespace DP
 {
-    Grid<float> ComputeEnergy(Texture const& texture)
+    namespace
     {
-        Grid<float> energy(texture.width, texture.height, 0.0f);
+#if defined(SEAMCARVING_SSE2)
+        // -1 where the left parent won, +1 where the right one did, 0 for straight up
+        inline __m128i Steps(__m128 tookLeft, __m128 tookRight)
+        {
+            __m128i left = _mm_castps_si128(tookLeft);
+            __m128i right = _mm_castps_si128(tookRight);
+            return _mm_or_si128(_mm_andnot_si128(right, left), _mm_and_si128(right, _mm_set1_epi32(1)));
+        }
+#endif
 
-        for (int y = 0; y < texture.height; ++y)
+        // Parent choice for one pixel, edges skip the missing neighbour
+        inline void RelaxPixel(float const* prev, float const* energy, float* cur, signed char* steps, int x, int last)
         {
-            for (int x = 0; x < texture.width; ++x)
+            float best = prev[x];
+            signed char step = 0;
+            if (x > 0 && prev[x - 1] < best)
             {
-                Pixel left = texture.GetPixel(x - 1, y);
-                Pixel right = texture.GetPixel(x + 1, y);
-                Pixel up = texture.GetPixel(x, y - 1);
-                Pixel down = texture.GetPixel(x, y + 1);
-
-                float dx = std::pow(float(right.r) - float(left.r), 2) +
-                    std::pow(float(right.g) - float(left.g), 2) +
-                    std::pow(float(right.b) - float(left.b), 2);
-
-                float dy = std::pow(float(down.r) - float(up.r), 2) +
-                    std::pow(float(down.g) - float(up.g), 2) +
-                    std::pow(float(down.b) - float(up.b), 2);
-
-                energy(x, y) = std::sqrt(dx + dy);
+                best = prev[x - 1];
+                step = -1;
             }
+            if (x < last && prev[x + 1] < best)
+            {
+                best = prev[x + 1];
+                step = 1;
+            }
+            cur[x] = energy[x] + best;
+            steps[x] = step;
         }
 
-        return energy;
+        // One row of a plane without column s, as two bulk moves: the span before the seam (only when
+        // the row changes place) and the span after it, one step left. dst may alias src.
+        template <typename T>
+        inline void CompactRow(T const* src, T* dst, int width, int s)
+        {
+            if (dst != src) std::memmove(dst, src, s * sizeof(T));
+            std::memmove(dst + s, src + s + 1, (width - s - 1) * sizeof(T));
+        }
     }
 
-    std::vector<int> FindVerticalSeam(Grid<float> const& energy)
+    void RelaxRow(float const* prev, float const* energy, float* cur, signed char* steps, int width)
     {
-        int width = energy.width;
-        int height = energy.height;
-
-        // Calculate cumulative energy using DP
-        Grid<float> cumulative(width, height);
+        RelaxSpan(prev, energy, cur, steps, width, 0, width);
+    }
 
-        for (int x = 0; x < width; ++x)
+    void RelaxSpan(float const* prev, float const* energy, float* cur, signed char* steps, int width, int begin, int end)
+    {
+        int last = width - 1;
+        int stop = std::min(end, last);
+
+        // three shifted loads of prev, a packed min and an add per vector; the masks of the two
+        // compares give the step, packed down to one byte per pixel
+        int x = std::max(begin, 1);
+#if defined(SEAMCARVING_AVX2)
+        for (; x + 8 <= stop; x += 8)
+        {
+            __m256 left = _mm256_loadu_ps(prev + x - 1);
+            __m256 up = _mm256_loadu_ps(prev + x);
+            __m256 right = _mm256_loadu_ps(prev + x + 1);
+
+            __m256 tookLeft = _mm256_cmp_ps(left, up, _CMP_LT_OQ);
+            __m256 best = _mm256_min_ps(left, up);
+            __m256 tookRight = _mm256_cmp_ps(right, best, _CMP_LT_OQ);
+            best = _mm256_min_ps(right, best);
+            _mm256_storeu_ps(cur + x, _mm256_add_ps(_mm256_loadu_ps(energy + x), best));
+
+            __m128i lo = Steps(_mm256_castps256_ps128(tookLeft), _mm256_castps256_ps128(tookRight));
+            __m128i hi = Steps(_mm256_extractf128_ps(tookLeft, 1), _mm256_extractf128_ps(tookRight, 1));
+            __m128i packed = _mm_packs_epi32(lo, hi);
+            _mm_storel_epi64((__m128i*)(steps + x), _mm_packs_epi16(packed, packed));
+        }
+#elif defined(SEAMCARVING_SSE2)
+        for (; x + 4 <= stop; x += 4)
+        {
+            __m128 left = _mm_loadu_ps(prev + x - 1);
+            __m128 up = _mm_loadu_ps(prev + x);
+            __m128 right = _mm_loadu_ps(prev + x + 1);
+
+            __m128 tookLeft = _mm_cmplt_ps(left, up);
+            __m128 best = _mm_min_ps(left, up);
+            __m128 tookRight = _mm_cmplt_ps(right, best);
+            best = _mm_min_ps(right, best);
+            _mm_storeu_ps(cur + x, _mm_add_ps(_mm_loadu_ps(energy + x), best));
+
+            __m128i packed = _mm_packs_epi32(Steps(tookLeft, tookRight), _mm_setzero_si128());
+            int bytes = _mm_cvtsi128_si32(_mm_packs_epi16(packed, packed));
+            std::memcpy(steps + x, &bytes, sizeof(bytes));
+        }
+#endif
+        for (; x < stop; ++x)
         {
-            cumulative(x, 0) = energy(x, 0);
+            RelaxPixel(prev, energy, cur, steps, x, last);
         }
 
-        for (int y = 1; y < height; ++y)
+        if (begin == 0 && end > 0) RelaxPixel(prev, energy, cur, steps, 0, last);
+        if (last > 0 && begin <= last && end == width) RelaxPixel(prev, energy, cur, steps, last, last);
+    }
+
+    void RelaxPaddedRow(float const* prev, float const* energy, float* cur, signed char* steps, int width)
+    {
+        // the +inf halo never wins a strict compare, so the edges take the same path as the interior
+        int x = 0;
+#if defined(SEAMCARVING_AVX2)
+        for (; x + 8 <= width; x += 8)
         {
-            for (int x = 0; x < width; ++x)
-            {
-                float left = (x > 0) ? cumulative(x - 1, y - 1) : std::numeric_limits<float>::max();
-                float up = cumulative(x, y - 1);
-                float right = (x < width - 1) ? cumulative(x + 1, y - 1) : std::numeric_limits<float>::max();
-                cumulative(x, y) = energy(x, y) + std::min({ left, up, right });
-            }
+            __m256 left = _mm256_loadu_ps(prev + x - 1);
+            __m256 up = _mm256_load_ps(prev + x);
+            __m256 right = _mm256_loadu_ps(prev + x + 1);
+
+            __m256 tookLeft = _mm256_cmp_ps(left, up, _CMP_LT_OQ);
+            __m256 best = _mm256_min_ps(left, up);
+            __m256 tookRight = _mm256_cmp_ps(right, best, _CMP_LT_OQ);
+            best = _mm256_min_ps(right, best);
+            _mm256_store_ps(cur + x, _mm256_add_ps(_mm256_loadu_ps(energy + x), best));
+
+            __m128i lo = Steps(_mm256_castps256_ps128(tookLeft), _mm256_castps256_ps128(tookRight));
+            __m128i hi = Steps(_mm256_extractf128_ps(tookLeft, 1), _mm256_extractf128_ps(tookRight, 1));
+            __m128i packed = _mm_packs_epi32(lo, hi);
+            _mm_storel_epi64((__m128i*)(steps + x), _mm_packs_epi16(packed, packed));
+        }
+#elif defined(SEAMCARVING_SSE2)
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128 left = _mm_loadu_ps(prev + x - 1);
+            __m128 up = _mm_load_ps(prev + x);
+            __m128 right = _mm_loadu_ps(prev + x + 1);
+
+            __m128 tookLeft = _mm_cmplt_ps(left, up);
+            __m128 best = _mm_min_ps(left, up);
+            __m128 tookRight = _mm_cmplt_ps(right, best);
+            best = _mm_min_ps(right, best);
+            _mm_store_ps(cur + x, _mm_add_ps(_mm_loadu_ps(energy + x), best));
+
+            __m128i packed = _mm_packs_epi32(Steps(tookLeft, tookRight), _mm_setzero_si128());
+            int bytes = _mm_cvtsi128_si32(_mm_packs_epi16(packed, packed));
+            std::memcpy(steps + x, &bytes, sizeof(bytes));
         }
+#endif
+        for (; x < width; ++x)
+        {
+            float left = prev[x - 1];
+            float up = prev[x];
+            float right = prev[x + 1];
 
-        // Find minimum seam
-        std::vector<int> seam(height);
+            float best = left < up ? left : up;
+            signed char step = left < up ? -1 : 0;
+            step = right < best ? 1 : step;
+            best = right < best ? right : best;
 
-        float minEnergy = std::numeric_limits<float>::max();
-        int minX = 0;
+            cur[x] = energy[x] + best;
+            steps[x] = step;
+        }
+    }
 
-        for (int x = 0; x < width; ++x)
+    std::vector<int> Backtrack(Grid<signed char> const& steps, int bottomX)
+    {
+        std::vector<int> seam(steps.height);
+        seam[steps.height - 1] = bottomX;
+
+        for (int y = steps.height - 1; y > 0; --y)
         {
-            if (cumulative(x, height - 1) < minEnergy)
-            {
-                minEnergy = cumulative(x, height - 1);
-                minX = x;
-            }
+            seam[y - 1] = seam[y] + steps.Row(y)[seam[y]];
         }
 
-        seam[height - 1] = minX;
+        return seam;
+    }
 
-        for (int y = height - 2; y >= 0; --y)
-        {
-            int prevX = seam[y + 1];
-            int bestX = prevX;
-            float bestEnergy = cumulative(prevX, y);
+    Grid<float> ComputeEnergy(Texture const& texture, Energy::Operator op, int downsample)
+    {
+        if (downsample > 1) return Energy::ComputePyramid(texture, downsample, op);
+        return Energy::ComputeParallel(texture, op);
+    }
 
-            if (prevX > 0 && cumulative(prevX - 1, y) < bestEnergy)
-            {
-                bestX = prevX - 1;
-                bestEnergy = cumulative(prevX - 1, y);
-            }
+    std::vector<int> FindVerticalSeam(Grid<float> const& energy)
+    {
+        int width = energy.width;
+        int height = energy.height;
 
-            if (prevX < width - 1 && cumulative(prevX + 1, y) < bestEnergy)
-            {
-                bestX = prevX + 1;
-                bestEnergy = cumulative(prevX + 1, y);
-            }
+        // Calculate cumulative energy using DP: two rolling +inf-padded rows, the choices are kept as int8 steps
+        PaddedGrid<float> rows(width, 2, std::numeric_limits<float>::infinity());
+        float* previous = rows.Row(0);
+        float* current = rows.Row(1);
+        std::copy(energy.Row(0), energy.Row(0) + width, previous);
+        Grid<signed char> steps(width, height);
 
-            seam[y] = bestX;
+        for (int y = 1; y < height; ++y)
+        {
+            RelaxPaddedRow(previous, energy.Row(y), current, steps.Row(y), width);
+            std::swap(previous, current);
         }
 
-        return seam;
+        // Find minimum seam, then follow the steps back up, one dependent load per row
+        int minX = static_cast<int>(std::min_element(previous, previous + width) - previous);
+        return Backtrack(steps, minX);
     }
 
     float CalculateVerticalSeamEnergy(Grid<float> const& energy, std::vector<int> const& seam)
@@ -106,97 +213,112 @@ namespace DP
         return totalEnergy;
     }
 
-    void RemoveVerticalSeam(Texture& texture, std::vector<int> const& seam)
+    void CompactVerticalSeam(Texture& texture, std::vector<int> const& seam, Grid<float>* energy, Grid<int>* columns)
     {
-        if (texture.width <= 1)
+        int width = texture.width;
+        int height = texture.height;
+        int stride = texture.stride;
+        bool hasLuminance = texture.HasLuminance();
+
+        // texture planes keep their stride, so only the span after the seam moves; grids are packed,
+        // a compacted row lands on the source of the rows above it, which is safe as rows go in order
+        for (int y = 0; y < height; ++y)
         {
-            std::cerr << "Cannot remove vertical seam, image is too small!" << std::endl;
-            return;
+            int s = seam[y];
+            CompactRow(texture.Row(y), texture.Row(y), width, s);
+            if (hasLuminance)
+            {
+                unsigned char* luma = texture.luminance.data() + y * stride;
+                CompactRow(luma, luma, width, s);
+            }
+            if (energy) CompactRow(energy->Row(y), energy->data.data() + y * (width - 1), width, s);
+            if (columns) CompactRow(columns->Row(y), columns->data.data() + y * (width - 1), width, s);
         }
 
-        std::vector<Pixel> newPixels((texture.width - 1) * texture.height);
+        texture.width = width - 1;
 
-        for (int y = 0; y < texture.height; ++y)
+        if (energy)
         {
-            int k = 0;
-            for (int x = 0; x < texture.width; ++x)
-            {
-                if (x != seam[y])
-                {
-                    newPixels[y * (texture.width - 1) + k] = texture.pixels[y * texture.width + x];
-                    ++k;
-                }
-            }
+            energy->data.resize(std::size_t(width - 1) * height);
+            energy->width = width - 1;
         }
 
-        --texture.width;
-        texture.pixels = std::move(newPixels);
-        std::cout << "Removed vertical seam. New size: " << texture.width << "x" << texture.height << std::endl;
+        if (columns)
+        {
+            columns->data.resize(std::size_t(width - 1) * height);
+            columns->width = width - 1;
+        }
     }
 
-    std::vector<int> FindHorizontalSeam(Grid<float> const& energy)
+    void RemoveVerticalSeam(Texture& texture, std::vector<int> const& seam, Grid<float>* energy)
     {
-        int width = energy.width;
-        int height = energy.height;
-
-        // DP table for cumulative energy
-        Grid<float> cumulative(width, height);
-
-        for (int y = 0; y < height; ++y)
+        if (texture.width <= 1)
         {
-            cumulative(0, y) = energy(0, y);
+            std::cerr << "Cannot remove vertical seam, image is too small!" << std::endl;
+            return;
         }
 
-        for (int x = 1; x < width; ++x)
-        {
-            for (int y = 0; y < height; ++y)
-            {
-                float up = (y > 0) ? cumulative(x - 1, y - 1) : std::numeric_limits<float>::max();
-                float left = cumulative(x - 1, y);
-                float down = (y < height - 1) ? cumulative(x - 1, y + 1) : std::numeric_limits<float>::max();
+        CompactVerticalSeam(texture, seam, energy);
+        std::cout << "Removed vertical seam. New size: " << texture.width << "x" << texture.height << std::endl;
+    }
 
-                cumulative(x, y) = energy(x, y) + std::min({ up, left, down });
-            }
+    void CarveVerticalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam, Energy::Operator op, int downsample)
+    {
+        if (downsample > 1)
+        {
+            energy = ComputeEnergy(texture, op, downsample);
+            return;
         }
 
-        // Find minimum seam
-        std::vector<int> seam(width);
-        float minEnergy = std::numeric_limits<float>::max();
-        int minY = 0;
+        int width = energy.width;
+        int height = energy.height;
 
         for (int y = 0; y < height; ++y)
         {
-            if (cumulative(width - 1, y) < minEnergy)
-            {
-                minEnergy = cumulative(width - 1, y);
-                minY = y;
-            }
+            CompactRow(energy.Row(y), energy.data.data() + y * (width - 1), width, seam[y]);
         }
 
-        seam[width - 1] = minY;
+        energy.width = width - 1;
+        energy.data.resize(std::size_t(width - 1) * height);
 
-        for (int x = width - 2; x >= 0; --x)
-        {
-            int prevY = seam[x + 1];
-            int bestY = prevY;
-            float bestEnergy = cumulative(x, prevY);
+        RefreshVerticalEnergy(energy, texture, seam, op);
+    }
 
-            if (prevY > 0 && cumulative(x, prevY - 1) < bestEnergy)
-            {
-                bestY = prevY - 1;
-                bestEnergy = cumulative(x, prevY - 1);
-            }
+    void RefreshVerticalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam, Energy::Operator op, int downsample)
+    {
+        if (downsample > 1)
+        {
+            energy = ComputeEnergy(texture, op, downsample);
+            return;
+        }
 
-            if (prevY < height - 1 && cumulative(x, prevY + 1) < bestEnergy)
-            {
-                bestY = prevY + 1;
-                bestEnergy = cumulative(x, prevY + 1);
-            }
+        int height = energy.height;
 
-            seam[x] = bestY;
+        // only pixels next to the seam, or below/above a seam step, have new neighbours;
+        // this also covers the diagonal taps of the 3x3 operators
+        for (int y = 0; y < height; ++y)
+        {
+            int above = seam[std::max(y - 1, 0)];
+            int below = seam[std::min(y + 1, height - 1)];
+            int begin = std::min({ above, seam[y], below }) - 1;
+            int end = std::max({ above, seam[y], below }) + 1;
+            Energy::ComputeSpan(texture, energy, y, begin, end, op);
         }
+    }
 
-        return seam;
+    std::vector<int> FindHorizontalSeam(Grid<float> const& energy)
+    {
+        // a horizontal seam is a vertical seam of the transpose; the vertical kernel breaks ties
+        // the same way (same row, then up, then down), so the seam is unchanged
+        return FindVerticalSeam(Transposed(energy));
+    }
+
+    void FindSeams(Grid<float> const& energy, std::vector<int>& vertical, std::vector<int>& horizontal, int workers)
+    {
+        // a fused strip sweep saved one read of the map but paid an extra transpose pass for it and
+        // measured slower, so the two searches run on their own; the vertical one uses the wavefront
+        vertical = FindVerticalSeamParallel(energy, workers);
+        horizontal = FindHorizontalSeam(energy);
     }
 
     float CalculateHorizontalSeamEnergy(Grid<float> const& energy, std::vector<int> const& seam)
@@ -217,23 +339,76 @@ namespace DP
             return;
         }
 
-        std::vector<Pixel> newPixels(texture.width * (texture.height - 1));
+        int width = texture.width;
+        int height = texture.height - 1;
+        int stride = texture.stride;
+        auto [lowest, highest] = std::minmax_element(seam.begin(), seam.end());
 
-        for (int x = 0; x < texture.width; ++x)
+        // row-major compaction in place: row y takes the old row y or y + 1 per column. Rows above
+        // the seam stay put and rows below it move up whole, only the rows it crosses are mixed.
+        // The buffer keeps its size; the last row is simply no longer part of the image.
+        auto compact = [&](auto* plane)
         {
-            int k = 0;
-            for (int y = 0; y < texture.height; ++y)
+            for (int y = *lowest; y < height; ++y)
             {
-                if (y != seam[x])
+                auto* dst = plane + y * stride;
+                auto const* below = dst + stride;
+
+                if (y >= *highest)
                 {
-                    newPixels[k * texture.width + x] = texture.pixels[y * texture.width + x];
-                    k++;
+                    std::copy(below, below + width, dst);
+                    continue;
+                }
+
+                for (int x = 0; x < width; ++x)
+                {
+                    if (y >= seam[x]) dst[x] = below[x];
                 }
             }
-        }
+        };
 
-        --texture.height;
-        texture.pixels = std::move(newPixels);
+        compact(texture.pixels.data());
+        if (texture.HasLuminance()) compact(texture.luminance.data());
+
+        texture.height = height;
         std::cout << "Removed horizontal seam. New size: " << texture.width << "x" << texture.height << std::endl;
     }
+
+    void CarveHorizontalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam, Energy::Operator op, int downsample)
+    {
+        if (downsample > 1)
+        {
+            energy = ComputeEnergy(texture, op, downsample);
+            return;
+        }
+
+        int width = energy.width;
+        int height = energy.height - 1;
+
+        // row-major compaction in place: row y takes the old row y or y + 1 per column
+        for (int y = 0; y < height; ++y)
+        {
+            float* dst = energy.Row(y);
+            for (int x = 0; x < width; ++x)
+            {
+                if (y >= seam[x]) dst[x] = energy.data[(y + 1) * width + x];
+            }
+        }
+
+        energy.height = height;
+        energy.data.resize(width * height);
+
+        // rows around the seam in each column, widened where the seam steps
+        for (int x = 0; x < width; ++x)
+        {
+            int before = seam[std::max(x - 1, 0)];
+            int after = seam[std::min(x + 1, width - 1)];
+            int begin = std::max(std::min({ before, seam[x], after }) - 1, 0);
+            int end = std::min(std::max({ before, seam[x], after }) + 1, height);
+            for (int y = begin; y < end; ++y)
+            {
+                Energy::ComputeSpan(texture, energy, y, x, x + 1, op);
+            }
+        }
+    }
 }
\ No newline at end of file
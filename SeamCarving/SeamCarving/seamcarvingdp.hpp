@@ -1,14 +1,108 @@
 #pragma once
+#include "energy.hpp"
 
 namespace DP
 {
-	Grid<float> ComputeEnergy(Texture const& texture);
+	// Full-resolution energy, or pyramid energy upsampled from a level `downsample` times smaller
+	Grid<float> ComputeEnergy(Texture const& texture, Energy::Operator op = Energy::Operator::L2, int downsample = 1);
+
+	// One DP row: cur[x] = energy[x] + the cheapest of prev[x - 1], prev[x], prev[x + 1], with the step
+	// taken into x (-1, 0, +1) written to steps. Ties prefer straight up, then left, then right.
+	void RelaxRow(float const* prev, float const* energy, float* cur, signed char* steps, int width);
+	// RelaxRow restricted to columns [begin, end) of a width-wide row; prev must be valid on [begin - 1, end + 1)
+	void RelaxSpan(float const* prev, float const* energy, float* cur, signed char* steps, int width, int begin, int end);
+	// RelaxRow over PaddedGrid rows: prev[-1] and prev[width] must be +inf and prev, cur aligned to the
+	// vector width, so the whole row runs without edge cases
+	void RelaxPaddedRow(float const* prev, float const* energy, float* cur, signed char* steps, int width);
+	// Seam ending at bottomX, following the steps written by RelaxRow back to the top row
+	std::vector<int> Backtrack(Grid<signed char> const& steps, int bottomX);
 
 	std::vector<int> FindVerticalSeam(Grid<float> const& energy);
 	float CalculateVerticalSeamEnergy(Grid<float> const& energy, std::vector<int> const& seam);
-	void RemoveVerticalSeam(Texture& texture, std::vector<int> const& seam);
+	// Drop a vertical seam from the texture planes and from grids carried along with it, in one pass
+	// over the rows with at most two memmoves per row and plane. Texture rows keep their stride, the
+	// grids (energy, source columns of a seam index map) are packed to the new width, in place.
+	void CompactVerticalSeam(Texture& texture, std::vector<int> const& seam, Grid<float>* energy = nullptr,
+		Grid<int>* columns = nullptr);
+	// CompactVerticalSeam, logging the new size
+	void RemoveVerticalSeam(Texture& texture, std::vector<int> const& seam, Grid<float>* energy = nullptr);
+	// Carve a persistent energy map along a seam already removed from the texture,
+	// recomputing only the pixels around the seam whose neighbours changed.
+	// Pyramid energy (downsample > 1) shifts its box blocks with every seam and is rebuilt instead.
+	void CarveVerticalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam,
+		Energy::Operator op = Energy::Operator::L2, int downsample = 1);
+	// CarveVerticalEnergy for a map already compacted along with the texture (RemoveVerticalSeam /
+	// CompactVerticalSeam): only the pixels around the seam are recomputed, pyramid energy is rebuilt
+	void RefreshVerticalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam,
+		Energy::Operator op = Energy::Operator::L2, int downsample = 1);
 
 	std::vector<int> FindHorizontalSeam(Grid<float> const& energy);
 	float CalculateHorizontalSeamEnergy(Grid<float> const& energy, std::vector<int> const& seam);
 	void RemoveHorizontalSeam(Texture& texture, std::vector<int> const& seam);
+	void CarveHorizontalEnergy(Grid<float>& energy, Texture const& texture, std::vector<int> const& seam,
+		Energy::Operator op = Energy::Operator::L2, int downsample = 1);
+
+	// Both seams of the same energy grid: the vertical one from FindVerticalSeamParallel with `workers`
+	// (0 = hardware threads, serial below Energy::kParallelThreshold), the horizontal one from FindHorizontalSeam.
+	void FindSeams(Grid<float> const& energy, std::vector<int>& vertical, std::vector<int>& horizontal, int workers = 0);
+
+	// Forward energy: a seam costs the colour differences across the edges its removal creates.
+	// Costs are computed from the pixel rows inside the cumulative pass, no energy grid is needed.
+	std::vector<int> FindVerticalSeamForward(Texture const& texture);
+	std::vector<int> FindHorizontalSeamForward(Texture const& texture);
+	// Forward cost of a seam on the texture it was found on, the value those searches minimise
+	float CalculateVerticalSeamForwardEnergy(Texture const& texture, std::vector<int> const& seam);
+	float CalculateHorizontalSeamForwardEnergy(Texture const& texture, std::vector<int> const& seam);
+
+	// Fused engine: each energy row is computed from three pixel rows and folded straight into a
+	// rolling cumulative row, keeping only a W x H table of int8 steps for backtracking.
+	// Same seam as FindVerticalSeam(ComputeEnergy(texture, op)) at full resolution.
+	std::vector<int> FindVerticalSeamStreaming(Texture const& texture, Energy::Operator op = Energy::Operator::L2);
+
+	// Vertical DP on column strips, one per worker (0 = hardware threads), tiled over blocks of rows:
+	// each worker fills an upright trapezoid in its strip, then the inverted trapezoids across strip
+	// borders, with one barrier after each half. Same seam as FindVerticalSeam; runs serially below
+	// Energy::kParallelThreshold or when strips would be too narrow.
+	std::vector<int> FindVerticalSeamParallel(Grid<float> const& energy, int workers = 0);
+
+	// Low-memory DP: two rolling cumulative lines and 2-bit packed steps (four pixels per byte, 16x
+	// smaller than a float grid); the horizontal search reads energy columns in place, no transpose.
+	// Same seams as FindVerticalSeam / FindHorizontalSeam.
+	std::vector<int> FindVerticalSeamLowMemory(Grid<float> const& energy);
+	std::vector<int> FindHorizontalSeamLowMemory(Grid<float> const& energy);
+
+	// Checkpointed DP for images whose W x H step table would exceed memoryBudget bytes: cumulative rows
+	// are kept every CheckpointInterval(H) ~ sqrt(H) rows and each segment between them is recomputed
+	// while backtracking, O(W * sqrt(H)) memory for about twice the row updates. Within the budget this
+	// is FindVerticalSeamParallel; the seam is the same either way.
+	int CheckpointInterval(int height);
+	std::vector<int> FindVerticalSeamCheckpointed(Grid<float> const& energy, std::size_t memoryBudget = std::size_t(256) << 20);
+
+	// Coarse-to-fine search: full DP on a pyramid level 2^(levels - 1) times smaller, then on every finer
+	// level only a band of bandRadius columns either side of the upsampled seam is searched, with energy
+	// computed inside the band alone. Not guaranteed to match FindVerticalSeam, see
+	// Analysis::CompareMultiresolutionSeams. levels = 1 is a plain full-resolution search.
+	std::vector<int> FindVerticalSeamMultiresolution(Texture const& texture, int levels, int bandRadius,
+		Energy::Operator op = Energy::Operator::L2);
+
+	// Downsample levels for the coarse-to-fine search kept across seams: levels[0] is half the source,
+	// each further level halves again while it stays wider than a band. After a seam left the source,
+	// RemoveVerticalSeam drops the matching column from every level whose width the halving shrinks;
+	// the levels then only approximate a fresh Downsample, which is enough to guide the bands.
+	struct SeamPyramid
+	{
+		std::vector<Texture> levels;
+
+		void Build(Texture const& texture, int count, int bandRadius);
+		void RemoveVerticalSeam(Texture const& texture, std::vector<int> const& seam);
+	};
+
+	// FindVerticalSeamMultiresolution on a pyramid the caller keeps for the current texture
+	std::vector<int> FindVerticalSeamMultiresolution(Texture const& texture, SeamPyramid const& pyramid, int bandRadius,
+		Energy::Operator op = Energy::Operator::L2);
+
+	// Integer pipeline: uint16 energy (see Energy::Quantize) and uint32 cumulative sums with packed
+	// unsigned min in the row update. The float functions above remain the reference.
+	std::vector<int> FindVerticalSeamFixed(Grid<uint16_t> const& energy);
+	std::vector<int> FindHorizontalSeamFixed(Grid<uint16_t> const& energy);
 }
\ No newline at end of file
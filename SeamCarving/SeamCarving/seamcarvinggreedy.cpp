@@ -24,22 +24,20 @@ namespace Greedy
 
         seam[0] = x;
 
-        // Greedy: At each row, pick the lowest-energy neighbor from the row below
+        // Greedy: At each row, pick the lowest-energy neighbor from the row below.
+        // Neighbour columns are clamped instead of bounds-checked: at an edge the clamped read is the
+        // pixel below itself, which never wins the strict compare, so the choice matches the checked walk.
+        int last = width - 1;
         for (int y = 1; y < height; ++y)
         {
-            int bestX = x;
-            float bestVal = energy(x, y);
+            float const* row = energy.Row(y);
+            int left = std::max(x - 1, 0);
+            int right = std::min(x + 1, last);
 
-            if (x > 0 && energy(x - 1, y) < bestVal)
-            {
-                bestVal = energy(x - 1, y);
-                bestX = x - 1;
-            }
-            if (x < width - 1 && energy(x + 1, y) < bestVal)
-            {
-                bestVal = energy(x + 1, y);
-                bestX = x + 1;
-            }
+            float bestVal = row[x];
+            int bestX = row[left] < bestVal ? left : x;
+            bestVal = row[bestX];
+            bestX = row[right] < bestVal ? right : bestX;
 
             x = bestX;
             seam[y] = x;
@@ -69,22 +67,17 @@ namespace Greedy
 
         seam[0] = y;
 
-        // Greedy: At each column, pick the lowest-energy neighbor from the next column
+        // Greedy: At each column, pick the lowest-energy neighbor from the next column, clamped as above
+        int last = height - 1;
         for (int x = 1; x < width; ++x)
         {
-            int bestY = y;
-            float bestVal = energy(x, y);
+            int up = std::max(y - 1, 0);
+            int down = std::min(y + 1, last);
 
-            if (y > 0 && energy(x, y - 1) < bestVal)
-            {
-                bestVal = energy(x, y - 1);
-                bestY = y - 1;
-            }
-            if (y < height - 1 && energy(x, y + 1) < bestVal)
-            {
-                bestVal = energy(x, y + 1);
-                bestY = y + 1;
-            }
+            float bestVal = energy.Row(y)[x];
+            int bestY = energy.Row(up)[x] < bestVal ? up : y;
+            bestVal = energy.Row(bestY)[x];
+            bestY = energy.Row(down)[x] < bestVal ? down : bestY;
 
             y = bestY;
             seam[x] = y;
@@ -0,0 +1,71 @@
+#include "../pch.h"
+#include "seamindexmap.hpp"
+#include "seamcarvingdp.hpp"
+#include "cumulativemap.hpp"
+
+namespace DP
+{
+    SeamIndexMap BuildSeamIndexMap(Texture const& texture, int minWidth, Energy::Operator op)
+    {
+        SeamIndexMap map;
+        map.minWidth = std::clamp(minWidth, 1, texture.width);
+        map.removedAt = Grid<int>(texture.width, texture.height, SeamIndexMap::kKept);
+
+        // working copy, and the source column each of its pixels came from
+        Texture carved = texture;
+        Grid<int> sourceColumn(texture.width, texture.height);
+        for (int y = 0; y < texture.height; ++y)
+        {
+            int* row = sourceColumn.Row(y);
+            for (int x = 0; x < texture.width; ++x) row[x] = x;
+        }
+
+        Grid<float> energy = ComputeEnergy(carved, op);
+        CumulativeMap cumulative;
+        cumulative.Build(energy);
+
+        for (int iteration = 0; carved.width > map.minWidth; ++iteration)
+        {
+            std::vector<int> seam = cumulative.FindVerticalSeam();
+            for (int y = 0; y < carved.height; ++y)
+            {
+                map.removedAt(sourceColumn(seam[y], y), y) = iteration;
+            }
+
+            // pixels, luminance, energy and source columns drop the seam in one pass
+            // (CompactVerticalSeam does not log, unlike RemoveVerticalSeam)
+            CompactVerticalSeam(carved, seam, &energy, &sourceColumn);
+            RefreshVerticalEnergy(energy, carved, seam, op);
+            cumulative.RemoveVerticalSeam(energy, seam);
+        }
+
+        return map;
+    }
+
+    Texture Retarget(Texture const& source, SeamIndexMap const& map, int targetWidth)
+    {
+        targetWidth = std::clamp(targetWidth, map.minWidth, source.width);
+        int removed = source.width - targetWidth;
+
+        Texture result{};
+        result.id = source.id;
+        result.Allocate(targetWidth, source.height);
+
+        // every seam takes exactly one pixel per row, so each row keeps exactly targetWidth pixels
+        for (int y = 0; y < source.height; ++y)
+        {
+            Pixel const* src = source.Row(y);
+            int const* order = map.removedAt.Row(y);
+            Pixel* dst = result.Row(y);
+
+            int k = 0;
+            for (int x = 0; x < source.width; ++x)
+            {
+                if (order[x] >= removed) dst[k++] = src[x];
+            }
+        }
+
+        if (source.HasLuminance()) result.BuildLuminance();
+        return result;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "energy.hpp"
+
+namespace DP
+{
+	// Multi-size image (Avidan & Shamir): the source carved once down to minWidth, recording for every
+	// source pixel the iteration whose vertical seam removed it. Pixels that survive store kKept.
+	struct SeamIndexMap
+	{
+		static constexpr int kKept = std::numeric_limits<int>::max();
+
+		int minWidth = 0;
+		Grid<int> removedAt{ 0, 0 };
+	};
+
+	// Carve texture down to minWidth with the incremental DP and record the removal order
+	SeamIndexMap BuildSeamIndexMap(Texture const& texture, int minWidth, Energy::Operator op = Energy::Operator::L2);
+
+	// Any width in [map.minWidth, source.width] in one gather pass, no energy or DP: a row keeps the
+	// pixels not removed by the first (source.width - targetWidth) seams
+	Texture Retarget(Texture const& source, SeamIndexMap const& map, int targetWidth);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Pick the widest instruction set the compiler was told it may use.
+// MSVC only defines __AVX2__ under /arch:AVX2, and never defines __SSE2__,
+// so x64 (which always has SSE2) is detected through _M_X64 instead.
+#if defined(__AVX2__)
+	#define SEAMCARVING_AVX2
+	#define SEAMCARVING_SSE2
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SEAMCARVING_SSE2
+	#include <emmintrin.h>
+#endif
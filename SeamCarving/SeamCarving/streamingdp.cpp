@@ -0,0 +1,30 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    std::vector<int> FindVerticalSeamStreaming(Texture const& texture, Energy::Operator op)
+    {
+        int width = texture.width;
+        int height = texture.height;
+
+        // the energy row and two +inf-padded cumulative rows are the only float storage
+        std::vector<float> energy(width);
+        PaddedGrid<float> rows(width, 2, std::numeric_limits<float>::infinity());
+        float* previous = rows.Row(0);
+        float* current = rows.Row(1);
+        Grid<signed char> steps(width, height);
+
+        Energy::ComputeRow(texture, 0, previous, op);
+
+        for (int y = 1; y < height; ++y)
+        {
+            Energy::ComputeRow(texture, y, energy.data(), op);
+            RelaxPaddedRow(previous, energy.data(), current, steps.Row(y), width);
+            std::swap(previous, current);
+        }
+
+        int minX = static_cast<int>(std::min_element(previous, previous + width) - previous);
+        return Backtrack(steps, minX);
+    }
+}
@@ -0,0 +1,226 @@
+#include "../pch.h"
+#include "transportmap.hpp"
+#include "seamcarvingdp.hpp"
+
+namespace DP
+{
+    namespace
+    {
+        // How seams are found and costed, matching the resize loop that replays the order
+        struct Settings
+        {
+            Energy::Operator op;
+            int downsample;
+            bool forward; // forward energy costs, no energy grid is kept
+        };
+
+        // An intermediate image of the transport map and its carved energy
+        struct Cell
+        {
+            Texture texture{};
+            Grid<float> energy{ 0, 0 };
+        };
+
+        // Tightly packed copy of a plane with one vertical seam left out
+        template <typename T>
+        std::vector<T> WithoutVerticalSeam(std::vector<T> const& plane, int width, int height, int stride, std::vector<int> const& seam)
+        {
+            std::vector<T> result((width - 1) * height);
+            for (int y = 0; y < height; ++y)
+            {
+                T const* src = plane.data() + y * stride;
+                T* dst = result.data() + y * (width - 1);
+                std::copy(src, src + seam[y], dst);
+                std::copy(src + seam[y] + 1, src + width, dst + seam[y]);
+            }
+            return result;
+        }
+
+        // Tightly packed copy of a plane with one horizontal seam left out, written row by row
+        template <typename T>
+        std::vector<T> WithoutHorizontalSeam(std::vector<T> const& plane, int width, int height, int stride, std::vector<int> const& seam)
+        {
+            std::vector<T> result(width * (height - 1));
+            for (int y = 0; y < height - 1; ++y)
+            {
+                T const* src = plane.data() + y * stride;
+                T* dst = result.data() + y * width;
+                for (int x = 0; x < width; ++x)
+                {
+                    dst[x] = y < seam[x] ? src[x] : src[x + stride];
+                }
+            }
+            return result;
+        }
+
+        // The next image along one direction: copy and carve in one pass instead of copy then remove
+        Cell Shrink(Cell const& cell, std::vector<int> const& seam, Removal removal, Settings const& settings)
+        {
+            Texture const& source = cell.texture;
+            Cell next;
+            next.texture.id = source.id;
+            next.energy = cell.energy;
+
+            if (removal == Removal::Vertical)
+            {
+                next.texture.width = source.width - 1;
+                next.texture.height = source.height;
+                next.texture.stride = next.texture.width;
+                next.texture.pixels = WithoutVerticalSeam(source.pixels, source.width, source.height, source.stride, seam);
+                if (source.HasLuminance()) next.texture.luminance = WithoutVerticalSeam(source.luminance, source.width, source.height, source.stride, seam);
+                if (!settings.forward) CarveVerticalEnergy(next.energy, next.texture, seam, settings.op, settings.downsample);
+            }
+            else
+            {
+                next.texture.width = source.width;
+                next.texture.height = source.height - 1;
+                next.texture.stride = next.texture.width;
+                next.texture.pixels = WithoutHorizontalSeam(source.pixels, source.width, source.height, source.stride, seam);
+                if (source.HasLuminance()) next.texture.luminance = WithoutHorizontalSeam(source.luminance, source.width, source.height, source.stride, seam);
+                if (!settings.forward) CarveHorizontalEnergy(next.energy, next.texture, seam, settings.op, settings.downsample);
+            }
+
+            return next;
+        }
+
+        std::vector<Removal> TransportMap(Texture const& texture, int rows, int columns, Settings const& settings)
+        {
+            // choice(c, r): how image(r, c) was reached
+            Grid<unsigned char> choice(columns + 1, rows + 1);
+
+            // slot c holds image(r - 1, c) until cell (r, c) replaces it with image(r, c)
+            std::vector<Cell> images(columns + 1);
+            std::vector<float> cost(columns + 1);
+
+            for (int r = 0; r <= rows; ++r)
+            {
+                for (int c = 0; c <= columns; ++c)
+                {
+                    if (r == 0 && c == 0)
+                    {
+                        images[0].texture = texture;
+                        if (!settings.forward) images[0].energy = ComputeEnergy(texture, settings.op, settings.downsample);
+                        cost[0] = 0.0f;
+                        continue;
+                    }
+
+                    float verticalCost = std::numeric_limits<float>::max();
+                    float horizontalCost = std::numeric_limits<float>::max();
+                    std::vector<int> verticalSeam;
+                    std::vector<int> horizontalSeam;
+
+                    if (c > 0)
+                    {
+                        Cell const& cell = images[c - 1];
+                        if (settings.forward)
+                        {
+                            verticalSeam = FindVerticalSeamForward(cell.texture);
+                            verticalCost = cost[c - 1] + CalculateVerticalSeamForwardEnergy(cell.texture, verticalSeam);
+                        }
+                        else
+                        {
+                            verticalSeam = FindVerticalSeam(cell.energy);
+                            verticalCost = cost[c - 1] + CalculateVerticalSeamEnergy(cell.energy, verticalSeam);
+                        }
+                    }
+
+                    if (r > 0)
+                    {
+                        Cell const& cell = images[c];
+                        if (settings.forward)
+                        {
+                            horizontalSeam = FindHorizontalSeamForward(cell.texture);
+                            horizontalCost = cost[c] + CalculateHorizontalSeamForwardEnergy(cell.texture, horizontalSeam);
+                        }
+                        else
+                        {
+                            horizontalSeam = FindHorizontalSeam(cell.energy);
+                            horizontalCost = cost[c] + CalculateHorizontalSeamEnergy(cell.energy, horizontalSeam);
+                        }
+                    }
+
+                    // ties go to the vertical seam, as in the greedy resize loops
+                    if (verticalCost <= horizontalCost)
+                    {
+                        images[c] = Shrink(images[c - 1], verticalSeam, Removal::Vertical, settings);
+                        cost[c] = verticalCost;
+                        choice(c, r) = static_cast<unsigned char>(Removal::Vertical);
+                    }
+                    else
+                    {
+                        images[c] = Shrink(images[c], horizontalSeam, Removal::Horizontal, settings);
+                        cost[c] = horizontalCost;
+                        choice(c, r) = static_cast<unsigned char>(Removal::Horizontal);
+                    }
+                }
+            }
+
+            // walk back from (rows, columns) to the source image
+            std::vector<Removal> order;
+            order.reserve(rows + columns);
+            for (int r = rows, c = columns; r > 0 || c > 0;)
+            {
+                Removal removal = static_cast<Removal>(choice(c, r));
+                order.push_back(removal);
+                if (removal == Removal::Vertical) --c;
+                else --r;
+            }
+
+            std::reverse(order.begin(), order.end());
+            return order;
+        }
+    }
+
+    std::vector<Removal> OptimalRemovalOrder(Texture const& texture, int targetWidth, int targetHeight,
+        Energy::Operator op, int downsample, bool forward, std::size_t memoryBudget)
+    {
+        Settings settings{ op, std::max(downsample, 1), forward };
+
+        int columns = texture.width - std::clamp(targetWidth, 1, texture.width);
+        int rows = texture.height - std::clamp(targetHeight, 1, texture.height);
+
+        // one image row of the table: pixels, luminance when carried and energy unless costs are forward
+        std::size_t bytesPerPixel = sizeof(Pixel) + (texture.HasLuminance() ? sizeof(unsigned char) : 0) + (forward ? 0 : sizeof(float));
+        auto rowBytes = [&](int factor)
+        {
+            std::size_t pixels = std::size_t(texture.width / factor + 1) * (texture.height / factor + 1);
+            return (columns / factor + 1) * pixels * bytesPerPixel;
+        };
+
+        int factor = 1;
+        while (rowBytes(factor) > memoryBudget && texture.width / (factor * 2) > 1 && texture.height / (factor * 2) > 1)
+        {
+            factor *= 2;
+        }
+
+        if (factor == 1) return TransportMap(texture, rows, columns, settings);
+
+        // coarse order, each step repeated factor times and trimmed to the exact seam counts
+        Texture coarse = Energy::Downsample(texture, factor);
+        int coarseColumns = std::min((columns + factor - 1) / factor, coarse.width - 1);
+        int coarseRows = std::min((rows + factor - 1) / factor, coarse.height - 1);
+
+        // the coarse level already stands for part of the requested energy downsampling
+        Settings coarseSettings = settings;
+        coarseSettings.downsample = std::max(settings.downsample / factor, 1);
+
+        std::vector<Removal> order;
+        order.reserve(rows + columns);
+        int verticalLeft = columns;
+        int horizontalLeft = rows;
+
+        for (Removal removal : TransportMap(coarse, coarseRows, coarseColumns, coarseSettings))
+        {
+            int& left = removal == Removal::Vertical ? verticalLeft : horizontalLeft;
+            for (int i = 0; i < factor && left > 0; ++i, --left)
+            {
+                order.push_back(removal);
+            }
+        }
+
+        // coarse levels can round a direction short, finish it at the end
+        order.insert(order.end(), verticalLeft, Removal::Vertical);
+        order.insert(order.end(), horizontalLeft, Removal::Horizontal);
+        return order;
+    }
+}
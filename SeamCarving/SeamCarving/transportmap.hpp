@@ -0,0 +1,24 @@
+#pragma once
+#include "energy.hpp"
+
+namespace DP
+{
+	enum class Removal : unsigned char
+	{
+		Vertical,
+		Horizontal
+	};
+
+	// Optimal order of vertical and horizontal seam removals down to targetWidth x targetHeight
+	// (Avidan & Shamir transport map): T(r, c) = min(T(r - 1, c) + E(horizontal seam of image(r - 1, c)),
+	// T(r, c - 1) + E(vertical seam of image(r, c - 1))), costing two seam searches per table cell.
+	// Seams and costs follow the settings the order is replayed with: energy computed at `downsample`
+	// (see ComputeEnergy), or forward energy costs when `forward` is set.
+	// Only one row of intermediate images is alive at a time. When that row would exceed memoryBudget
+	// bytes the map is computed on a Downsample level and every coarse step stands for several seams.
+	// Planning is far more work than picking the cheaper of two seams at every step; only the replay,
+	// which searches a single direction per seam, is cheaper.
+	std::vector<Removal> OptimalRemovalOrder(Texture const& texture, int targetWidth, int targetHeight,
+		Energy::Operator op = Energy::Operator::L2, int downsample = 1, bool forward = false,
+		std::size_t memoryBudget = std::size_t(256) << 20);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Tile edge for Transposed: a tile of floats read along rows and written along columns stays in L1
+constexpr int kTransposeBlock = 32;
+
+// Transpose rows [beginY, endY) of grid into result (height x width), tile by tile: walking the grid
+// in tiles keeps both the source rows and the destination columns of a tile resident instead of
+// striding a full row per element
+template <typename T>
+void TransposeRows(Grid<T> const& grid, Grid<T>& result, int beginY, int endY)
+{
+	int width = grid.width;
+	int height = grid.height;
+
+	for (int by = beginY; by < endY; by += kTransposeBlock)
+	{
+		int blockEndY = std::min(by + kTransposeBlock, endY);
+		for (int bx = 0; bx < width; bx += kTransposeBlock)
+		{
+			int endX = std::min(bx + kTransposeBlock, width);
+			for (int y = by; y < blockEndY; ++y)
+			{
+				T const* src = grid.Row(y);
+				for (int x = bx; x < endX; ++x)
+				{
+					result.data[x * height + y] = src[x];
+				}
+			}
+		}
+	}
+}
+
+// Cache-blocked transpose, result(y, x) = grid(x, y)
+template <typename T>
+Grid<T> Transposed(Grid<T> const& grid)
+{
+	Grid<T> result(grid.height, grid.width);
+	TransposeRows(grid, result, 0, grid.height);
+	return result;
+}
@@ -0,0 +1,98 @@
+#include "../pch.h"
+#include "transposedmap.hpp"
+#include "seamcarvingdp.hpp"
+#include "transpose.hpp"
+
+namespace DP
+{
+    void TransposedMap::Build(Grid<float> const& energy)
+    {
+        // the buffer only grows back after a new image, carved maps keep their allocation
+        transposed.width = energy.height;
+        transposed.height = energy.width;
+        transposed.data.resize(std::size_t(energy.width) * energy.height);
+        TransposeRows(energy, transposed, 0, energy.height);
+    }
+
+    std::vector<int> TransposedMap::FindHorizontalSeam() const
+    {
+        return FindVerticalSeam(transposed);
+    }
+
+    void TransposedMap::RemoveVerticalSeam(Grid<float> const& energy, std::vector<int> const& seam)
+    {
+        int columns = transposed.width;
+        int rows = transposed.height - 1;
+        auto [lowest, highest] = std::minmax_element(seam.begin(), seam.end());
+        int mixedEnd = std::min(*highest, rows);
+
+        // a vertical seam is a horizontal seam of the transpose: the rows it crosses take the row below
+        // where they are at or past it, the rows from its far end on move up whole in one move
+        for (int x = *lowest; x < mixedEnd; ++x)
+        {
+            float* dst = transposed.Row(x);
+            float const* below = dst + columns;
+            for (int y = 0; y < columns; ++y)
+            {
+                if (x >= seam[y]) dst[y] = below[y];
+            }
+        }
+
+        if (mixedEnd < rows)
+        {
+            std::memmove(transposed.Row(mixedEnd), transposed.Row(mixedEnd + 1), std::size_t(rows - mixedEnd) * columns * sizeof(float));
+        }
+
+        transposed.height = rows;
+        transposed.data.resize(std::size_t(rows) * columns);
+
+        // the spans RefreshVerticalEnergy recomputed
+        int width = energy.width;
+        for (int y = 0; y < columns; ++y)
+        {
+            int above = seam[std::max(y - 1, 0)];
+            int below = seam[std::min(y + 1, columns - 1)];
+            int begin = std::max(std::min({ above, seam[y], below }) - 1, 0);
+            int end = std::min(std::max({ above, seam[y], below }) + 1, width);
+            float const* row = energy.Row(y);
+            for (int x = begin; x < end; ++x)
+            {
+                transposed.data[x * columns + y] = row[x];
+            }
+        }
+    }
+
+    void TransposedMap::RemoveHorizontalSeam(Grid<float> const& energy, std::vector<int> const& seam)
+    {
+        int width = transposed.width;
+        int rows = transposed.height;
+
+        // a horizontal seam is a vertical seam of the transpose: every row drops one entry, packed in order
+        for (int x = 0; x < rows; ++x)
+        {
+            int s = seam[x];
+            float const* src = transposed.Row(x);
+            float* dst = transposed.data.data() + x * (width - 1);
+            if (dst != src) std::memmove(dst, src, s * sizeof(float));
+            std::memmove(dst + s, src + s + 1, (width - s - 1) * sizeof(float));
+        }
+
+        transposed.width = width - 1;
+        transposed.data.resize(std::size_t(width - 1) * rows);
+
+        // the spans CarveHorizontalEnergy recomputed, contiguous in the transpose
+        int height = energy.height;
+        for (int x = 0; x < rows; ++x)
+        {
+            int before = seam[std::max(x - 1, 0)];
+            int after = seam[std::min(x + 1, rows - 1)];
+            int begin = std::max(std::min({ before, seam[x], after }) - 1, 0);
+            int end = std::min(std::max({ before, seam[x], after }) + 1, height);
+            float* row = transposed.Row(x);
+            for (int y = begin; y < end; ++y)
+            {
+                row[y] = energy(x, y);
+            }
+        }
+    }
+}
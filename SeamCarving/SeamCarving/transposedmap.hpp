@@ -0,0 +1,23 @@
+#pragma once
+
+namespace DP
+{
+	// Transposed copy of a persistent energy map, carved along with it after every removed seam, so
+	// horizontal seams are searched as vertical seams of the transpose without transposing the whole
+	// map per seam. Same seams as DP::FindHorizontalSeam on the energy it mirrors.
+	struct TransposedMap
+	{
+		Grid<float> transposed{ 0, 0 };
+
+		// Full transpose into the kept buffer, also used after pyramid energy was rebuilt
+		void Build(Grid<float> const& energy);
+
+		std::vector<int> FindHorizontalSeam() const;
+
+		// Call after the energy was carved along the seam at full resolution (CarveVerticalEnergy /
+		// RefreshVerticalEnergy, CarveHorizontalEnergy): the seam is removed from the transpose and only
+		// the entries those functions recomputed are copied over
+		void RemoveVerticalSeam(Grid<float> const& energy, std::vector<int> const& seam);
+		void RemoveHorizontalSeam(Grid<float> const& energy, std::vector<int> const& seam);
+	};
+}
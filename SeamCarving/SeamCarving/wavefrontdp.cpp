@@ -0,0 +1,81 @@
+#include "../pch.h"
+#include "seamcarvingdp.hpp"
+#include "parallel.hpp"
+
+namespace DP
+{
+    namespace
+    {
+        // Rows per block; the trapezoids lose one column per row on each inner strip border
+        constexpr int kBlockRows = 64;
+    }
+
+    std::vector<int> FindVerticalSeamParallel(Grid<float> const& energy, int workers)
+    {
+        int width = energy.width;
+        int height = energy.height;
+
+        if (workers <= 0) workers = Parallel::HardwareWorkers();
+        workers = std::min(workers, width / 8);
+
+        // block height is limited by the narrowest strip, whose trapezoid shrinks from both sides
+        int blockRows = std::min(kBlockRows, width / std::max(workers, 1) / 2);
+        if (workers <= 1 || blockRows < 2 || width * height < Energy::kParallelThreshold)
+        {
+            return FindVerticalSeam(energy);
+        }
+
+        std::vector<int> borders(workers + 1);
+        for (int i = 0; i <= workers; ++i) borders[i] = width * i / workers;
+
+        // ring of blockRows + 1 cumulative rows: a block reads the last row of the previous block
+        int ringRows = blockRows + 1;
+        Grid<float> ring(width, ringRows);
+        Grid<signed char> steps(width, height);
+        std::copy(energy.Row(0), energy.Row(0) + width, ring.Row(0));
+
+        Parallel::Barrier barrier(workers);
+
+        // one strip per band, so every worker reaches each barrier exactly once per phase
+        Parallel::ForBands(workers, workers, [&](int strip, int)
+        {
+            int left = borders[strip];
+            int right = borders[strip + 1];
+            bool hasLeft = strip > 0;
+            bool hasRight = strip < workers - 1;
+
+            for (int top = 0; top + 1 < height; top += blockRows)
+            {
+                int rows = std::min(blockRows, height - 1 - top);
+
+                // upright trapezoid: row r of the block shrinks by r - 1 at each inner border,
+                // so it only ever reads columns this strip computed itself
+                for (int r = 1; r <= rows; ++r)
+                {
+                    int y = top + r;
+                    int begin = hasLeft ? left + (r - 1) : left;
+                    int stop = hasRight ? right - (r - 1) : right;
+                    RelaxSpan(ring.Row((y - 1) % ringRows), energy.Row(y), ring.Row(y % ringRows), steps.Row(y), width, begin, stop);
+                }
+
+                barrier.Wait();
+
+                // inverted trapezoid over the border to the right, filling what both sides left out
+                if (hasRight)
+                {
+                    for (int r = 2; r <= rows; ++r)
+                    {
+                        int y = top + r;
+                        RelaxSpan(ring.Row((y - 1) % ringRows), energy.Row(y), ring.Row(y % ringRows), steps.Row(y), width, right - (r - 1), right + (r - 1));
+                    }
+                }
+
+                barrier.Wait();
+            }
+        });
+
+        float const* bottom = ring.Row((height - 1) % ringRows);
+        int minX = static_cast<int>(std::min_element(bottom, bottom + width) - bottom);
+        return Backtrack(steps, minX);
+    }
+}
@@ -5,14 +5,22 @@
 #include "Core/glapp.hpp"
 #include "Core/gui.hpp"
 
+// energy operators and kernels
+#include "SeamCarving/energy.hpp"
+
 // seam carving using dynamic programming
 #include "SeamCarving/seamcarvingdp.hpp"
+#include "SeamCarving/cumulativemap.hpp"
+#include "SeamCarving/transposedmap.hpp"
+#include "SeamCarving/seamindexmap.hpp"
+#include "SeamCarving/transportmap.hpp"
 
 // seam carving using greedy algorithm
 #include "SeamCarving/seamcarvinggreedy.hpp"
 
 // analysis and comparison tools
 #include "SeamCarving/analysis.hpp"
+#include "SeamCarving/parallel.hpp"
 
 int main()
 {
@@ -24,6 +32,8 @@ int main()
     UpdateTexture(texture);
     
     static bool isProcessing = false;
+    static Energy::Operator energyOperator = Energy::Operator::L2;
+    static int energyDownsample = 1; // pyramid level the energy is computed on (1 = full resolution)
 
     while (app.IsRunning())
     {
@@ -99,9 +109,26 @@ int main()
 
         ImGui::Begin("Basic Controls");
         {
+            if (ImGui::BeginCombo("Energy", Energy::OperatorName(energyOperator)))
+            {
+                for (int i = 0; i < static_cast<int>(Energy::Operator::Count); ++i)
+                {
+                    Energy::Operator op = static_cast<Energy::Operator>(i);
+                    if (ImGui::Selectable(Energy::OperatorName(op), op == energyOperator)) energyOperator = op;
+                }
+                ImGui::EndCombo();
+            }
+
+            static char const* resolutions[] = { "Full", "1/2 (Pyramid)", "1/4 (Pyramid)" };
+            static int resolution = 0;
+            if (ImGui::Combo("Energy Resolution", &resolution, resolutions, IM_ARRAYSIZE(resolutions)))
+            {
+                energyDownsample = 1 << resolution;
+            }
+
             if (ImGui::Button("Remove Horizontal (DP)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
                 std::vector<int> seam = DP::FindHorizontalSeam(energy);
                 DP::RemoveHorizontalSeam(texture, seam);
                 UpdateTexture(texture);
@@ -109,17 +136,18 @@ int main()
 
             if (ImGui::Button("Remove Vertical (DP)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
-                std::vector<int> seam = DP::FindVerticalSeam(energy);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
+                // checkpointed once the step table would exceed the default memory budget
+                std::vector<int> seam = DP::FindVerticalSeamCheckpointed(energy);
                 DP::RemoveVerticalSeam(texture, seam);
                 UpdateTexture(texture);
             }
             
             if (ImGui::Button("Remove Lowest Energy Seam (DP)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
-                auto vSeam = DP::FindVerticalSeam(energy);
-                auto hSeam = DP::FindHorizontalSeam(energy);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
+                std::vector<int> vSeam, hSeam;
+                DP::FindSeams(energy, vSeam, hSeam);
                 float vEnergy = DP::CalculateVerticalSeamEnergy(energy, vSeam);
                 float hEnergy = DP::CalculateHorizontalSeamEnergy(energy, hSeam);
                 if (vEnergy < hEnergy) DP::RemoveVerticalSeam(texture, vSeam);
@@ -127,9 +155,23 @@ int main()
                 UpdateTexture(texture);
             }
 
+            if (ImGui::Button("Remove Horizontal (Forward DP)"))
+            {
+                std::vector<int> seam = DP::FindHorizontalSeamForward(texture);
+                DP::RemoveHorizontalSeam(texture, seam);
+                UpdateTexture(texture);
+            }
+
+            if (ImGui::Button("Remove Vertical (Forward DP)"))
+            {
+                std::vector<int> seam = DP::FindVerticalSeamForward(texture);
+                DP::RemoveVerticalSeam(texture, seam);
+                UpdateTexture(texture);
+            }
+
             if (ImGui::Button("Remove Horizontal (Greedy)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture); // same energy computation
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample); // same energy computation
                 std::vector<int> seam = Greedy::FindHorizontalSeamGreedy(energy);
                 DP::RemoveHorizontalSeam(texture, seam);
                 UpdateTexture(texture);
@@ -137,7 +179,7 @@ int main()
 
             if (ImGui::Button("Remove Vertical (Greedy)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
                 std::vector<int> seam = Greedy::FindVerticalSeamGreedy(energy);
                 DP::RemoveVerticalSeam(texture, seam);
                 UpdateTexture(texture);
@@ -145,7 +187,7 @@ int main()
 
             if (ImGui::Button("Remove Lowest Energy Seam (Greedy)"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
                 auto vSeam = Greedy::FindVerticalSeamGreedy(energy);
                 auto hSeam = Greedy::FindHorizontalSeamGreedy(energy);
                 float vEnergy = DP::CalculateVerticalSeamEnergy(energy, vSeam);
@@ -166,30 +208,99 @@ int main()
             ImGui::Text("Compare DP vs Greedy Performance");
             ImGui::Separator();
 
+            // DP rows of the comparison table use the rolling-line, 2-bit step search and its footprint
+            static bool lowMemoryDP = false;
+            ImGui::Checkbox("Low-Memory DP", &lowMemoryDP);
+
             if (ImGui::Button("Analyze Vertical Seam"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
 
                 std::vector<int> dpSeam, greedySeam;
 
-                auto dpMetrics = Analysis::MeasureDPVerticalSeam(energy, dpSeam);
+                auto dpMetrics = lowMemoryDP ? Analysis::MeasureDPLowMemoryVerticalSeam(energy, dpSeam)
+                                             : Analysis::MeasureDPVerticalSeam(energy, dpSeam);
                 auto greedyMetrics = Analysis::MeasureGreedyVerticalSeam(energy, greedySeam);
 
                 Analysis::PrintComparisonTable(dpMetrics, greedyMetrics, "Vertical Seam");
                 Analysis::CompareSeams(dpSeam, greedySeam, "DP", "Greedy");
+
+                std::vector<int> forwardSeam;
+                auto forwardMetrics = Analysis::MeasureDPForwardVerticalSeam(texture, energy, forwardSeam);
+                std::cout << "\nForward DP: " << forwardMetrics.computationTimeMs << " ms, seam energy "
+                    << forwardMetrics.seamEnergy << ", memory " << forwardMetrics.memoryUsed << " bytes" << std::endl;
+                Analysis::CompareSeams(dpSeam, forwardSeam, "DP", "Forward DP");
+
+                auto parallelStart = std::chrono::high_resolution_clock::now();
+                std::vector<int> parallelSeam = DP::FindVerticalSeamParallel(energy);
+                auto parallelEnd = std::chrono::high_resolution_clock::now();
+                std::cout << "\nWavefront DP (" << Parallel::HardwareWorkers() << " workers): "
+                    << std::chrono::duration<double, std::milli>(parallelEnd - parallelStart).count() << " ms" << std::endl;
+                Analysis::CompareSeams(dpSeam, parallelSeam, "DP", "Wavefront DP");
+
+                // the streaming engine always works at full resolution, energy pass included in its time
+                std::vector<int> streamingSeam;
+                auto streamingMetrics = Analysis::MeasureDPStreamingVerticalSeam(texture, energy, energyOperator, streamingSeam);
+                std::cout << "\nStreaming DP (energy + DP): " << streamingMetrics.computationTimeMs << " ms, seam energy "
+                    << streamingMetrics.seamEnergy << ", memory " << streamingMetrics.memoryUsed << " bytes" << std::endl;
+                Analysis::CompareSeams(dpSeam, streamingSeam, "DP", "Streaming DP");
+
+                // zero budget forces the checkpointed path so its cost shows up even on small images
+                std::vector<int> checkpointedSeam;
+                auto checkpointedMetrics = Analysis::MeasureDPCheckpointedVerticalSeam(energy, 0, checkpointedSeam);
+                std::cout << "\nCheckpointed DP: " << checkpointedMetrics.computationTimeMs << " ms, seam energy "
+                    << checkpointedMetrics.seamEnergy << ", memory " << checkpointedMetrics.memoryUsed << " bytes" << std::endl;
+                Analysis::CompareSeams(dpSeam, checkpointedSeam, "DP", "Checkpointed DP");
             }
 
             if (ImGui::Button("Analyze Horizontal Seam"))
             {
-                Grid<float> energy = DP::ComputeEnergy(texture);
+                Grid<float> energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
 
                 std::vector<int> dpSeam, greedySeam;
 
-                auto dpMetrics = Analysis::MeasureDPHorizontalSeam(energy, dpSeam);
+                auto dpMetrics = lowMemoryDP ? Analysis::MeasureDPLowMemoryHorizontalSeam(energy, dpSeam)
+                                             : Analysis::MeasureDPHorizontalSeam(energy, dpSeam);
                 auto greedyMetrics = Analysis::MeasureGreedyHorizontalSeam(energy, greedySeam);
 
                 Analysis::PrintComparisonTable(dpMetrics, greedyMetrics, "Horizontal Seam");
                 Analysis::CompareSeams(dpSeam, greedySeam, "DP", "Greedy");
+
+                std::vector<int> forwardSeam;
+                auto forwardMetrics = Analysis::MeasureDPForwardHorizontalSeam(texture, energy, forwardSeam);
+                std::cout << "\nForward DP: " << forwardMetrics.computationTimeMs << " ms, seam energy "
+                    << forwardMetrics.seamEnergy << ", memory " << forwardMetrics.memoryUsed << " bytes" << std::endl;
+                Analysis::CompareSeams(dpSeam, forwardSeam, "DP", "Forward DP");
+            }
+
+            if (ImGui::Button("Benchmark Energy Kernels"))
+            {
+                Analysis::CompareEnergyKernels(texture, 10);
+            }
+
+            if (ImGui::Button("Compare Energy Operators"))
+            {
+                Analysis::CompareEnergyOperators(texture, 10);
+            }
+
+            if (ImGui::Button("Compare Pyramid Energy"))
+            {
+                Analysis::ComparePyramidEnergy(texture, energyOperator);
+            }
+
+            static int multiresolutionLevels = 3;
+            static int bandRadius = 4;
+            ImGui::SliderInt("Pyramid Levels", &multiresolutionLevels, 2, 5);
+            ImGui::SliderInt("Band Radius", &bandRadius, 1, 32);
+
+            if (ImGui::Button("Compare Multiresolution Seams"))
+            {
+                Analysis::CompareMultiresolutionSeams(texture, energyOperator, multiresolutionLevels, bandRadius, 20);
+            }
+
+            if (ImGui::Button("Compare Fixed-Point DP"))
+            {
+                Analysis::CompareFixedPointSeams(texture, energyOperator);
             }
 
             ImGui::Separator();
@@ -251,42 +362,170 @@ int main()
             static int targetWidth = texture.width;
             static int targetHeight = texture.height;
 
+            static bool useForwardEnergy = false;
+            static bool useOptimalOrder = false;
+
             ImGui::InputInt("Target Width", &targetWidth);
             ImGui::InputInt("Target Height", &targetHeight);
+            ImGui::Checkbox("Forward Energy", &useForwardEnergy);
+            ImGui::Checkbox("Optimal Order (Transport Map)", &useOptimalOrder);
+            if (useOptimalOrder)
+            {
+                ImGui::TextWrapped("Plans up front with two seam searches per (rows x columns) table cell: more work "
+                    "overall than picking the cheaper of two seams each step, only the replay is cheaper.");
+            }
 
             targetWidth = std::clamp(targetWidth, 1, texture.width);
             targetHeight = std::clamp(targetHeight, 1, texture.height);
 
-            if (ImGui::Button("Resize Image (DP)"))
+            // energy map carved along with the texture instead of rebuilt every seam
+            static Grid<float> energy(0, 0);
+
+            // vertical cumulative sums patched after each seam instead of rebuilt
+            static DP::CumulativeMap verticalMap;
+
+            // transposed energy carved along with the map, horizontal seams need no per-seam transpose
+            static DP::TransposedMap horizontalMap;
+
+            // removal directions planned up front, replayed one seam per frame
+            static std::vector<DP::Removal> removalOrder;
+            static size_t removalStep = 0;
+
+            // transport map being planned on a worker, the resize starts once it is ready
+            static std::future<std::vector<DP::Removal>> pendingOrder;
+            static auto planStart = std::chrono::high_resolution_clock::now();
+
+            auto startResize = [&]()
             {
                 isResizing = true;
+                energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
+                verticalMap.Build(energy);
+                horizontalMap.Build(energy);
+            };
+
+            if (ImGui::Button("Resize Image (DP)"))
+            {
                 isProcessing = true;
+                removalOrder.clear();
+                removalStep = 0;
+
+                if (useOptimalOrder)
+                {
+                    // planning runs many seam searches, keep it off the frame so the window stays responsive
+                    planStart = std::chrono::high_resolution_clock::now();
+                    pendingOrder = std::async(std::launch::async,
+                        [source = texture, width = targetWidth, height = targetHeight, op = energyOperator, downsample = energyDownsample, forward = useForwardEnergy]()
+                        {
+                            return DP::OptimalRemovalOrder(source, width, height, op, downsample, forward);
+                        });
+                }
+                else
+                {
+                    startResize();
+                }
+            }
+
+            if (pendingOrder.valid())
+            {
+                if (pendingOrder.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                {
+                    removalOrder = pendingOrder.get();
+                    auto end = std::chrono::high_resolution_clock::now();
+                    std::cout << "Transport map for " << removalOrder.size() << " seams computed in "
+                        << std::chrono::duration<double, std::milli>(end - planStart).count() << " ms" << std::endl;
+                    startResize();
+                }
+                else
+                {
+                    ImGui::Text("Planning removal order...");
+                }
             }
 
             if (isResizing)
             {
                 if (texture.width > targetWidth || texture.height > targetHeight)
                 {
-                    Grid<float> energy = DP::ComputeEnergy(texture);
                     std::vector<int> vSeam;
                     std::vector<int> hSeam;
                     float vEnergy = std::numeric_limits<float>::max();
                     float hEnergy = std::numeric_limits<float>::max();
 
-                    if (texture.width > targetWidth)
+                    // with a planned order only the seam in the planned direction is searched
+                    bool planned = removalStep < removalOrder.size();
+                    DP::Removal next = planned ? removalOrder[removalStep++] : DP::Removal::Vertical;
+                    if (planned && (next == DP::Removal::Vertical ? texture.width <= targetWidth : texture.height <= targetHeight)) planned = false;
+
+                    bool searchVertical = texture.width > targetWidth && (!planned || next == DP::Removal::Vertical);
+                    bool searchHorizontal = texture.height > targetHeight && (!planned || next == DP::Removal::Horizontal);
+
+                    auto findVertical = [&]()
                     {
-                        vSeam = DP::FindVerticalSeam(energy);
-                        vEnergy = DP::CalculateVerticalSeamEnergy(energy, vSeam);
+                        // forward seams are compared on the forward cost they were chosen by
+                        if (useForwardEnergy)
+                        {
+                            vSeam = DP::FindVerticalSeamForward(texture);
+                            vEnergy = DP::CalculateVerticalSeamForwardEnergy(texture, vSeam);
+                        }
+                        else
+                        {
+                            vSeam = verticalMap.FindVerticalSeam();
+                            vEnergy = DP::CalculateVerticalSeamEnergy(energy, vSeam);
+                        }
+                    };
+
+                    auto findHorizontal = [&]()
+                    {
+                        if (useForwardEnergy)
+                        {
+                            hSeam = DP::FindHorizontalSeamForward(texture);
+                            hEnergy = DP::CalculateHorizontalSeamForwardEnergy(texture, hSeam);
+                        }
+                        else
+                        {
+                            hSeam = horizontalMap.FindHorizontalSeam();
+                            hEnergy = DP::CalculateHorizontalSeamEnergy(energy, hSeam);
+                        }
+                    };
+
+                    // the two searches only read the texture, energy and map, so they can run side by side
+                    if (searchVertical && searchHorizontal) Parallel::Invoke(findVertical, findHorizontal);
+                    else if (searchVertical) findVertical();
+                    else if (searchHorizontal) findHorizontal();
+
+                    if (vEnergy < hEnergy)
+                    {
+                        // pyramid energy is rebuilt after every seam, so it is not worth compacting
+                        DP::RemoveVerticalSeam(texture, vSeam, energyDownsample == 1 ? &energy : nullptr);
+                        DP::RefreshVerticalEnergy(energy, texture, vSeam, energyOperator, energyDownsample);
+
+                        // pyramid energy changes everywhere, so only full-resolution maps can be patched
+                        if (energyDownsample > 1)
+                        {
+                            verticalMap.Build(energy);
+                            horizontalMap.Build(energy);
+                        }
+                        else
+                        {
+                            verticalMap.RemoveVerticalSeam(energy, vSeam);
+                            horizontalMap.RemoveVerticalSeam(energy, vSeam);
+                        }
                     }
-
-                    if (texture.height > targetHeight)
+                    else
                     {
-                        hSeam = DP::FindHorizontalSeam(energy);
-                        hEnergy = DP::CalculateHorizontalSeamEnergy(energy, hSeam);
+                        DP::RemoveHorizontalSeam(texture, hSeam);
+                        DP::CarveHorizontalEnergy(energy, texture, hSeam, energyOperator, energyDownsample);
+
+                        if (energyDownsample > 1)
+                        {
+                            verticalMap.Build(energy);
+                            horizontalMap.Build(energy);
+                        }
+                        else
+                        {
+                            verticalMap.RemoveHorizontalSeam(energy, hSeam);
+                            horizontalMap.RemoveHorizontalSeam(energy, hSeam);
+                        }
                     }
-
-                    if (vEnergy < hEnergy) DP::RemoveVerticalSeam(texture, vSeam);
-                    else DP::RemoveHorizontalSeam(texture, hSeam);
                     UpdateTexture(texture);
                 }
                 else
@@ -296,6 +535,31 @@ int main()
                     isResizing = false;
                 }
             }
+
+            ImGui::Separator();
+
+            // carve once down to a single column, then serve any width from the recorded removal order
+            static Texture multiSizeSource{};
+            static DP::SeamIndexMap seamIndexMap;
+            static int multiSizeWidth = 0;
+
+            if (ImGui::Button("Precompute Seam Index Map"))
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                multiSizeSource = texture;
+                seamIndexMap = DP::BuildSeamIndexMap(texture, 1, energyOperator);
+                multiSizeWidth = texture.width;
+                auto end = std::chrono::high_resolution_clock::now();
+                std::cout << "Seam index map for " << texture.width << "x" << texture.height << " built in "
+                    << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+            }
+
+            if (seamIndexMap.removedAt.width == multiSizeSource.width && multiSizeSource.width > 0 &&
+                ImGui::SliderInt("Multi-Size Width", &multiSizeWidth, seamIndexMap.minWidth, multiSizeSource.width))
+            {
+                texture = DP::Retarget(multiSizeSource, seamIndexMap, multiSizeWidth);
+                UpdateTexture(texture);
+            }
         }
         ImGui::End();
 
@@ -311,10 +575,13 @@ int main()
             targetWidthGreedy = std::clamp(targetWidthGreedy, 1, texture.width);
             targetHeightGreedy = std::clamp(targetHeightGreedy, 1, texture.height);
 
+            static Grid<float> energy(0, 0);
+
             if (ImGui::Button("Resize Image (Greedy)"))
             {
                 isResizingGreedy = true;
                 isProcessing = true;
+                energy = DP::ComputeEnergy(texture, energyOperator, energyDownsample);
             }
 
             // remove several greedy seams per frame so it�s not painfully slow
@@ -328,8 +595,6 @@ int main()
                        (texture.width > targetWidthGreedy ||
                         texture.height > targetHeightGreedy))
                 {
-                    Grid<float> energy = DP::ComputeEnergy(texture);
-
                     std::vector<int> vSeam;
                     std::vector<int> hSeam;
                     float vEnergy = std::numeric_limits<float>::max();
@@ -355,8 +620,17 @@ int main()
                         break;
                     }
 
-                    if (vEnergy < hEnergy) DP::RemoveVerticalSeam(texture, vSeam);
-                    else DP::RemoveHorizontalSeam(texture, hSeam);
+                    if (vEnergy < hEnergy)
+                    {
+                        // pyramid energy is rebuilt after every seam, so it is not worth compacting
+                        DP::RemoveVerticalSeam(texture, vSeam, energyDownsample == 1 ? &energy : nullptr);
+                        DP::RefreshVerticalEnergy(energy, texture, vSeam, energyOperator, energyDownsample);
+                    }
+                    else
+                    {
+                        DP::RemoveHorizontalSeam(texture, hSeam);
+                        DP::CarveHorizontalEnergy(energy, texture, hSeam, energyOperator, energyDownsample);
+                    }
 
                     ++seamsDone;
                 }
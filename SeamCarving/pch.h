@@ -27,6 +27,9 @@
 #include <algorithm>
 #include <cstring>
 #include <iomanip>
+#include <cstdint>
+#include <thread>
+#include <future>
 
 // containers
 union Pixel
@@ -39,12 +42,30 @@ union Pixel
     unsigned char data[4];
 };
 
+// 8-bit BT.601 luma in fixed point
+inline unsigned char Luminance(Pixel pixel)
+{
+    return static_cast<unsigned char>((77 * pixel.r + 150 * pixel.g + 29 * pixel.b + 128) >> 8);
+}
+
 struct Texture
 {
     GLuint id;
     int width;
     int height;
-    std::vector<Pixel> pixels;
+    int stride; // allocated pixels per row; seam removal shrinks width in place and keeps the stride
+    std::vector<Pixel> pixels; // stride * height, row y starts at y * stride
+    std::vector<unsigned char> luminance; // optional, same layout as pixels, empty unless BuildLuminance was called
+
+    // Tightly packed storage for a w x h image (stride = w), without a luminance plane
+    void Allocate(int w, int h)
+    {
+        width = w;
+        height = h;
+        stride = w;
+        pixels.assign(std::size_t(w) * h, Pixel{});
+        luminance.clear();
+    }
 
     void SetPixel(int x, int y, Pixel pixel)
     {
@@ -53,14 +74,46 @@ struct Texture
             return;
         }
 
-        pixels[y * width + x] = pixel;
+        pixels[y * stride + x] = pixel;
+        if (HasLuminance()) luminance[y * stride + x] = Luminance(pixel);
     }
 
     Pixel GetPixel(int x, int y) const
     {
         x = std::clamp(x, 0, width - 1);
         y = std::clamp(y, 0, height - 1);
-        return pixels[y * width + x];
+        return pixels[y * stride + x];
+    }
+
+    // Unclamped row access for kernels that handle the borders themselves
+    Pixel* Row(int y)
+    {
+        return pixels.data() + y * stride;
+    }
+
+    Pixel const* Row(int y) const
+    {
+        return pixels.data() + y * stride;
+    }
+
+    // Derive the luminance plane from the pixels; seam removal keeps it in sync from then on
+    void BuildLuminance()
+    {
+        luminance.resize(pixels.size());
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            luminance[i] = Luminance(pixels[i]);
+        }
+    }
+
+    bool HasLuminance() const
+    {
+        return !luminance.empty();
+    }
+
+    unsigned char const* LuminanceRow(int y) const
+    {
+        return luminance.data() + y * stride;
     }
 };
 
@@ -88,4 +141,64 @@ struct Grid
         y = std::clamp(y, 0, height - 1);
         return data[y * width + x];
     }
+
+    T* Row(int y)
+    {
+        return data.data() + y * width;
+    }
+
+    T const* Row(int y) const
+    {
+        return data.data() + y * width;
+    }
+};
+
+// Grid whose rows carry a one-cell halo on each side, Row(y)[-1] and Row(y)[width], holding a fixed
+// value (+inf for DP costs) so neighbour reads need no bounds checks. Every row starts on a kAlignment
+// boundary for aligned vector loads; the stride covers the halo and the padding up to the next boundary.
+// Not copyable: a copied buffer would lose the alignment.
+template <typename T>
+struct PaddedGrid
+{
+    static constexpr int kAlignment = 64;
+    static constexpr int kLead = kAlignment / sizeof(T);
+
+    int width, height, stride;
+
+    PaddedGrid(int w, int h, T halo) : width(w), height(h), stride((kLead + w + 1 + kLead - 1) / kLead * kLead),
+        storage(std::size_t(stride) * h + kLead, halo)
+    {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage.data());
+        offset = static_cast<int>((kAlignment - address % kAlignment) % kAlignment / sizeof(T));
+    }
+
+    PaddedGrid(PaddedGrid const&) = delete;
+    PaddedGrid& operator=(PaddedGrid const&) = delete;
+    PaddedGrid(PaddedGrid&&) = default;
+    PaddedGrid& operator=(PaddedGrid&&) = default;
+
+    // unchecked, x may be -1 or width to read the halo
+    T& operator()(int x, int y)
+    {
+        return Row(y)[x];
+    }
+
+    T const& operator()(int x, int y) const
+    {
+        return Row(y)[x];
+    }
+
+    T* Row(int y)
+    {
+        return storage.data() + offset + y * stride + kLead;
+    }
+
+    T const* Row(int y) const
+    {
+        return storage.data() + offset + y * stride + kLead;
+    }
+
+private:
+    std::vector<T> storage;
+    int offset = 0;
 };
\ No newline at end of file